@@ -0,0 +1,94 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/pool_allocator.hpp"
+#include "luacpp/register_closure.hpp"
+#include "luacpp/load.hpp"
+
+namespace
+{
+	void load_and_call(lua::stack &s)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range("return 3"), "test").value();
+		lua::stack_value result = s.call(compiled, lua::no_arguments(), lua::one());
+		BOOST_REQUIRE_EQUAL(boost::make_optional<lua_Integer>(3), get_integer(result));
+	}
+
+	void call_closure(lua::stack &s)
+	{
+		auto bound = std::make_shared<lua_Number>(2);
+		lua::stack_value closure = lua::register_closure(s, [bound](lua_State *L)
+		{
+			lua_pushnumber(L, *bound);
+			return 1;
+		});
+		lua::stack_value result = s.call(closure, lua::no_arguments(), lua::one());
+		BOOST_REQUIRE_EQUAL(boost::make_optional<lua_Number>(2), get_number(result));
+	}
+
+	void build_tables(lua::stack &s)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range(
+			"local t = {}\n"
+			"for i = 1, 200 do\n"
+			"    t[i] = {name = \"element\" .. i, get = function () return i end}\n"
+			"end\n"
+			"return #t\n"
+			), "test").value();
+		lua::stack_value result = s.call(compiled, lua::no_arguments(), lua::one());
+		BOOST_REQUIRE_EQUAL(boost::make_optional<lua_Integer>(200), get_integer(result));
+	}
+
+	template <class Workload>
+	void compare_allocators(char const *default_name, char const *pool_name, std::size_t repetitions, Workload const &workload)
+	{
+		benchmark::run(default_name, repetitions, [&workload]()
+		{
+			auto state = lua::create_lua();
+			lua::stack s(*state);
+			workload(s);
+		});
+		benchmark::run(pool_name, repetitions, [&workload]()
+		{
+			lua::pool_allocator allocator;
+			auto state = lua::create_lua(allocator);
+			lua::stack s(*state);
+			workload(s);
+		});
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_allocator_load_and_call)
+{
+	compare_allocators("load and call, default allocator", "load and call, pool allocator", 20000, load_and_call);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_allocator_call_closure)
+{
+	compare_allocators("register and call closure, default allocator", "register and call closure, pool allocator", 20000, call_closure);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_allocator_build_tables)
+{
+	compare_allocators("build tables, default allocator", "build tables, pool allocator", 2000, build_tables);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_allocator_long_lived_state)
+{
+	{
+		auto state = lua::create_lua();
+		lua::stack s(*state);
+		benchmark::run("build tables in a long-lived state, default allocator", 2000, [&s]()
+		{
+			build_tables(s);
+		});
+	}
+	{
+		lua::pool_allocator allocator;
+		auto state = lua::create_lua(allocator);
+		lua::stack s(*state);
+		benchmark::run("build tables in a long-lived state, pool allocator", 2000, [&s]()
+		{
+			build_tables(s);
+		});
+	}
+}
@@ -0,0 +1,61 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/from_lua_cast.hpp"
+
+namespace
+{
+	std::vector<lua_Number> make_numbers(std::size_t count)
+	{
+		std::vector<lua_Number> numbers(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			numbers[i] = static_cast<lua_Number>(i) * 0.5;
+		}
+		return numbers;
+	}
+
+	void compare_conversions(std::size_t element_count, std::size_t repetitions)
+	{
+		std::vector<lua_Number> const numbers = make_numbers(element_count);
+		auto state = lua::create_lua();
+		lua_State &L = *state;
+		std::cout << element_count << " numbers\n";
+		benchmark::run("push with set_element", repetitions, [&L, &numbers]()
+		{
+			lua::stack_value table = lua::create_table(L);
+			for (std::size_t i = 0; i < numbers.size(); ++i)
+			{
+				lua::set_element(table, static_cast<lua_Integer>(i + 1), numbers[i]);
+			}
+		});
+		benchmark::run("push std::vector", repetitions, [&L, &numbers]()
+		{
+			lua::push(L, numbers);
+			lua::stack_value table(L, lua_gettop(&L));
+		});
+
+		lua::push(L, numbers);
+		lua::stack_value table(L, lua_gettop(&L));
+		benchmark::run("read with get_element", repetitions, [&table, &numbers]()
+		{
+			std::vector<lua_Number> converted;
+			for (std::size_t i = 0; i < numbers.size(); ++i)
+			{
+				lua::stack_value element = lua::get_element(table, static_cast<lua_Integer>(i + 1));
+				converted.emplace_back(lua::from_lua_cast<lua_Number>(element));
+			}
+			BOOST_REQUIRE_EQUAL(numbers.size(), converted.size());
+		});
+		benchmark::run("from_lua<std::vector>", repetitions, [&table, &numbers]()
+		{
+			std::vector<lua_Number> const converted = lua::from_lua_cast<std::vector<lua_Number>>(table);
+			BOOST_REQUIRE_EQUAL(numbers.size(), converted.size());
+		});
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_array_conversion)
+{
+	compare_conversions(10000, 200);
+	compare_conversions(1000000, 3);
+}
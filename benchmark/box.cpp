@@ -0,0 +1,34 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/box.hpp"
+
+namespace
+{
+	struct large_session
+	{
+		std::array<char, 16 * 1024> buffer;
+	};
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_boxed_user_data)
+{
+	auto state = lua::create_lua();
+	lua::stack s(*state);
+	auto const session = std::make_shared<large_session>();
+	std::size_t const repetitions = 100000;
+	benchmark::run("emplace_object with a copy of a 16 KB object", repetitions, [&s, &session]()
+	{
+		lua::stack_value object = lua::emplace_object<large_session>(s, lua::registered_meta_table<large_session>(), *session);
+	});
+	lua_gc(state.get(), LUA_GCCOLLECT, 0);
+	benchmark::run("push_shared of a 16 KB object", repetitions, [&s, &session]()
+	{
+		lua::stack_value object = lua::push_shared(s, session);
+	});
+	lua_gc(state.get(), LUA_GCCOLLECT, 0);
+	benchmark::run("push_borrowed of a 16 KB object", repetitions, [&s, &session]()
+	{
+		lua::stack_value object = lua::push_borrowed(s, *session);
+	});
+	lua_gc(state.get(), LUA_GCCOLLECT, 0);
+}
@@ -0,0 +1,62 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "test/temporary_directory.hpp"
+#include "luacpp/bundle.hpp"
+#include <boost/lexical_cast.hpp>
+
+namespace
+{
+	std::string generate_module(std::size_t functions)
+	{
+		std::string script = "local module = {}\n";
+		for (std::size_t i = 0; i < functions; ++i)
+		{
+			std::string const index = boost::lexical_cast<std::string>(i);
+			script += "function module.f" + index + "(a, b)\n    return a * " + index + " + b\nend\n";
+		}
+		script += "return module\n";
+		return script;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_bundle_vs_source_files)
+{
+	std::size_t const script_count = 50;
+	test::temporary_directory directory;
+	boost::filesystem::path const scripts = directory.path / "scripts";
+	boost::filesystem::create_directories(scripts);
+	std::vector<std::string> names;
+	for (std::size_t i = 0; i < script_count; ++i)
+	{
+		names.emplace_back("module" + boost::lexical_cast<std::string>(i) + ".lua");
+		test::write_file(scripts / names.back(), generate_module(50));
+	}
+
+	benchmark::run("compile_directory, 50 scripts", 20, [&scripts, script_count]()
+	{
+		lua::bytecode_bundle const compiled = lua::compile_directory(scripts);
+		BOOST_REQUIRE_EQUAL(script_count, compiled.size());
+	});
+
+	boost::filesystem::path const bundle_path = directory.path / "scripts.bundle";
+	lua::write_bundle(bundle_path, lua::compile_directory(scripts));
+
+	auto state = lua::create_lua();
+	benchmark::run("load 50 scripts with load_file", 100, [&state, &scripts, &names]()
+	{
+		for (std::string const &name : names)
+		{
+			lua::result loaded = lua::load_file(*state, scripts / name);
+			BOOST_REQUIRE(!loaded.is_error());
+		}
+	});
+	benchmark::run("load 50 scripts from a bundle, including opening it", 100, [&state, &bundle_path, &names]()
+	{
+		lua::bundle_file const bundle(bundle_path);
+		for (std::string const &name : names)
+		{
+			lua::result loaded = lua::load_from_bundle(*state, bundle, name);
+			BOOST_REQUIRE(!loaded.is_error());
+		}
+	});
+}
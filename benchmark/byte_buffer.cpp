@@ -0,0 +1,33 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/byte_buffer.hpp"
+#include "luacpp/from_lua_cast.hpp"
+#include "luacpp/load.hpp"
+
+namespace
+{
+	template <class Payload>
+	void pass_through_handler(char const *name, lua::stack &s, Payload const &payload)
+	{
+		lua::stack_value handler = lua::load_buffer(*s.state(), Si::make_c_str_range("local payload = ... return payload"), "handler").value();
+		benchmark::run(name, 2000, [&s, &handler, &payload]()
+		{
+			std::array<Payload, 1> const arguments = {{payload}};
+			lua::stack_value result = s.call(handler, Si::make_container_source(arguments), lua::one());
+			BOOST_REQUIRE_EQUAL(65536, lua::from_lua_cast<Si::memory_range>(result).size());
+		});
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_byte_buffer_vs_string)
+{
+	auto state = lua::create_lua();
+	lua::stack s(*state);
+	std::vector<char> content(65536);
+	for (std::size_t i = 0; i < content.size(); ++i)
+	{
+		content[i] = static_cast<char>(i * 7);
+	}
+	pass_through_handler("64 KiB through a handler as a string", s, Si::make_memory_range(content));
+	pass_through_handler("64 KiB through a handler as a byte_buffer", s, lua::make_byte_buffer(content));
+}
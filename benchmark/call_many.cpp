@@ -0,0 +1,51 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/from_lua_cast.hpp"
+#include "luacpp/load.hpp"
+#include <silicium/sink/iterator_sink.hpp>
+
+namespace
+{
+	typedef std::tuple<lua_Number, lua_Number, lua_Integer> record;
+
+	std::vector<record> make_records(std::size_t count)
+	{
+		std::vector<record> records;
+		records.reserve(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			records.emplace_back(static_cast<lua_Number>(i) * 0.25, static_cast<lua_Number>(i % 100), static_cast<lua_Integer>(i % 7));
+		}
+		return records;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_call_many)
+{
+	auto state = lua::create_lua();
+	lua::stack s(*state);
+	lua::stack_value compiled = lua::load_buffer(*state, Si::make_c_str_range(
+		"return function (price, rating, category) return price * 0.5 + rating * category end"
+		), "benchmark").value();
+	lua::stack_value score = s.call(compiled, lua::no_arguments(), lua::one());
+	std::vector<record> const records = make_records(1000000);
+	std::vector<lua_Number> scores;
+	scores.reserve(records.size());
+
+	benchmark::run("1M records with a loop over stack::call", 1, [&s, &score, &records, &scores]()
+	{
+		scores.clear();
+		for (record const &arguments : records)
+		{
+			std::array<lua_Number, 3> const pushed_arguments = {{std::get<0>(arguments), std::get<1>(arguments), static_cast<lua_Number>(std::get<2>(arguments))}};
+			lua::stack_value result = s.call(score, Si::make_container_source(pushed_arguments), lua::one());
+			scores.emplace_back(lua::from_lua_cast<lua_Number>(result));
+		}
+	});
+	benchmark::run("1M records with call_many", 1, [&s, &score, &records, &scores]()
+	{
+		scores.clear();
+		s.call_many<lua_Number>(score, Si::make_container_source(records), Si::make_container_sink(scores));
+	});
+	BOOST_CHECK_EQUAL(records.size(), scores.size());
+}
@@ -0,0 +1,41 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/meta_table.hpp"
+
+namespace
+{
+	struct widget
+	{
+		lua_Integer id;
+	};
+
+	char const * const widget_meta_table_name = "benchmark.widget";
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_checked_user_data_cast)
+{
+	auto state = lua::create_lua();
+	lua_State &L = *state;
+	lua::stack s(L);
+	widget const initial = {1};
+	lua::stack_value object = lua::emplace_object<widget>(s, lua::registered_meta_table<widget>(), initial);
+	//the same meta table is also registered by name for luaL_checkudata
+	BOOST_REQUIRE(lua_getmetatable(&L, object.from_bottom()));
+	lua_setfield(&L, LUA_REGISTRYINDEX, widget_meta_table_name);
+	int const address = object.from_bottom();
+	std::size_t const repetitions = 10000000;
+	lua_Integer sum = 0;
+	benchmark::run("lua_touserdata without a check", repetitions, [&L, address, &sum]()
+	{
+		sum += static_cast<widget *>(lua_touserdata(&L, address))->id;
+	});
+	benchmark::run("luaL_checkudata", repetitions, [&L, address, &sum]()
+	{
+		sum += static_cast<widget *>(luaL_checkudata(&L, address, widget_meta_table_name))->id;
+	});
+	benchmark::run("to_object", repetitions, [&L, address, &sum]()
+	{
+		sum += lua::to_object<widget>(L, address)->id;
+	});
+	BOOST_CHECK_EQUAL(static_cast<lua_Integer>(3 * repetitions), sum);
+}
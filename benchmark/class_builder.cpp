@@ -0,0 +1,78 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/class_builder.hpp"
+#include "luacpp/load.hpp"
+
+namespace
+{
+	struct counter
+	{
+		lua_Number value;
+
+		lua_Number get_value() const
+		{
+			return value;
+		}
+
+		void add(lua_Number summand)
+		{
+			value += summand;
+		}
+	};
+
+	///a separate type because the meta table is cached per type
+	struct bound_counter
+	{
+		lua_Number value;
+	};
+
+	void measure_loop(lua::stack &s, char const *name, lua::stack_value const &object, char const *code)
+	{
+		lua::stack_value loop = lua::load_buffer(*s.state(), Si::make_c_str_range(code), "benchmark").value();
+		benchmark::run(name, 100, [&s, &loop, &object]()
+		{
+			lua::push(*s.state(), loop);
+			lua::push(*s.state(), object);
+			lua_call(s.state(), 1, 0);
+		});
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_class_builder)
+{
+	auto state = lua::create_lua();
+	lua::stack s(*state);
+	{
+		lua::stack_value meta = lua::create_default_meta_table<counter>(s, [&s](lua::stack_value &table)
+		{
+			lua::add_method(s, table, "get_value", &counter::get_value);
+			lua::add_method(s, table, "add", &counter::add);
+		});
+		counter const initial = {0};
+		lua::stack_value object = lua::emplace_object<counter>(s, meta, initial);
+		measure_loop(s, "10000 method calls with add_method", object,
+			"local c = ... for i = 1, 10000 do c:add(1) end");
+		measure_loop(s, "10000 property reads through a getter with add_method", object,
+			"local c = ... local sum = 0 for i = 1, 10000 do sum = sum + c:get_value() end");
+	}
+	{
+		lua::stack_value meta = lua::create_default_meta_table<bound_counter>(s, [&s](lua::stack_value &table)
+		{
+			lua::class_builder<bound_counter>()
+				.property("value", &bound_counter::value)
+				.method("add", [](bound_counter &c, lua_Number summand)
+				{
+					c.value += summand;
+				})
+				.apply(s, table);
+		});
+		bound_counter const initial = {0};
+		lua::stack_value object = lua::emplace_object<bound_counter>(s, meta, initial);
+		measure_loop(s, "10000 method calls with class_builder", object,
+			"local c = ... for i = 1, 10000 do c:add(1) end");
+		measure_loop(s, "10000 property reads with class_builder", object,
+			"local c = ... local sum = 0 for i = 1, 10000 do sum = sum + c.value end");
+		measure_loop(s, "10000 property writes with class_builder", object,
+			"local c = ... for i = 1, 10000 do c.value = i end");
+	}
+}
@@ -0,0 +1,46 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/register_closure.hpp"
+#include <memory>
+
+namespace
+{
+	std::size_t const closure_count = 100000;
+
+	template <class ClosureFactory>
+	void measure_collection(char const *name, ClosureFactory const &make_closure)
+	{
+		auto state = lua::create_lua();
+		lua::stack s(*state);
+		lua_gc(state.get(), LUA_GCSTOP, 0);
+		for (std::size_t i = 0; i < closure_count; ++i)
+		{
+			lua::stack_value closure = lua::register_closure(s, make_closure());
+		}
+		//one full collection frees all of the short-lived closures
+		benchmark::run(name, 1, [&state]()
+		{
+			lua_gc(state.get(), LUA_GCCOLLECT, 0);
+		});
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_gc_pause_for_short_lived_closures)
+{
+	lua_State *captured = nullptr;
+	measure_collection("collect 100k trivially destructible closures", [captured]()
+	{
+		return [captured](lua_State *) -> lua::result_or_yield
+		{
+			return 0;
+		};
+	});
+	auto const shared = std::make_shared<int>(0);
+	measure_collection("collect 100k closures with a finalizer", [shared]()
+	{
+		return [shared](lua_State *) -> lua::result_or_yield
+		{
+			return 0;
+		};
+	});
+}
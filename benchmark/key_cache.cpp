@@ -0,0 +1,46 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/key_cache.hpp"
+
+namespace
+{
+	char const * const field_name = "content_length_of_the_response";
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_key_cache_field_access)
+{
+	auto state = lua::create_lua();
+	lua_State &L = *state;
+	lua::key_cache const keys(lua::main_thread(L), {field_name});
+	lua::interned_key const field = keys[0];
+	lua::stack_value table = lua::create_table(L);
+	std::size_t const repetitions = 1000000;
+
+	benchmark::run("set_element with a char const * key", repetitions, [&table]()
+	{
+		lua::set_element(table, field_name, static_cast<lua_Integer>(1));
+	});
+	benchmark::run("set_element with an interned key", repetitions, [&table, field]()
+	{
+		lua::set_element(table, field, static_cast<lua_Integer>(1));
+	});
+	benchmark::run("get_element with a char const * key", repetitions, [&table]()
+	{
+		lua::stack_value element = lua::get_element(table, field_name);
+	});
+	benchmark::run("get_element with an interned key", repetitions, [&table, field]()
+	{
+		lua::stack_value element = lua::get_element(table, field);
+	});
+	benchmark::run("lua_getfield", repetitions, [&L, &table]()
+	{
+		lua_getfield(&L, table.from_bottom(), field_name);
+		lua_pop(&L, 1);
+	});
+	benchmark::run("lua_rawgeti of the key and lua_gettable", repetitions, [&L, &table, field]()
+	{
+		lua::push(L, field);
+		lua_gettable(&L, table.from_bottom());
+		lua_pop(&L, 1);
+	});
+}
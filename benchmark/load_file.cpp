@@ -0,0 +1,47 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "test/temporary_directory.hpp"
+#include "luacpp/load_mapped_file.hpp"
+#include "luacpp/state.hpp"
+#include <boost/lexical_cast.hpp>
+
+namespace
+{
+	std::string generate_script(std::size_t functions)
+	{
+		std::string script = "local module = {}\n";
+		for (std::size_t i = 0; i < functions; ++i)
+		{
+			std::string const index = boost::lexical_cast<std::string>(i);
+			script += "function module.f" + index + "(a, b)\n    return a * " + index + " + b\nend\n";
+		}
+		script += "return module\n";
+		return script;
+	}
+
+	template <class Load>
+	void load_many_times(char const *name, boost::filesystem::path const &script, Load const &load)
+	{
+		auto state = lua::create_lua();
+		benchmark::run(name, 2000, [&state, &script, &load]()
+		{
+			lua::result loaded = load(*state, script);
+			BOOST_REQUIRE(!loaded.is_error());
+		});
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_load_file_vs_mapped)
+{
+	test::temporary_directory directory;
+	boost::filesystem::path const script = directory.path / "script.lua";
+	test::write_file(script, generate_script(200));
+	load_many_times("load_file", script, [](lua_State &L, boost::filesystem::path const &file)
+	{
+		return lua::load_file(L, file);
+	});
+	load_many_times("load_mapped_file", script, [](lua_State &L, boost::filesystem::path const &file)
+	{
+		return lua::load_mapped_file(L, file);
+	});
+}
@@ -0,0 +1,32 @@
+#ifndef LUACPP_BENCHMARK_MEASURE_HPP
+#define LUACPP_BENCHMARK_MEASURE_HPP
+
+#include <chrono>
+#include <iostream>
+
+namespace benchmark
+{
+	template <class Function>
+	std::chrono::nanoseconds measure(std::size_t repetitions, Function &&run)
+	{
+		auto const start = std::chrono::steady_clock::now();
+		for (std::size_t i = 0; i < repetitions; ++i)
+		{
+			run();
+		}
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+	}
+
+	inline void report(std::ostream &out, char const *name, std::size_t repetitions, std::chrono::nanoseconds elapsed)
+	{
+		out << name << ": " << (elapsed.count() / static_cast<std::chrono::nanoseconds::rep>(repetitions)) << " ns per iteration (" << repetitions << " iterations)\n";
+	}
+
+	template <class Function>
+	void run(char const *name, std::size_t repetitions, Function &&function)
+	{
+		report(std::cout, name, repetitions, measure(repetitions, std::forward<Function>(function)));
+	}
+}
+
+#endif
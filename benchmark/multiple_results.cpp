@@ -0,0 +1,78 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/register_any_function.hpp"
+#include "luacpp/load.hpp"
+
+namespace
+{
+	char const * const caller_script =
+		"local divide = ...\n"
+		"local sum = 0\n"
+		"for i = 1, 1000 do\n"
+		"    local quotient, remainder = divide(i, 7)\n"
+		"    sum = sum + quotient + remainder\n"
+		"end\n"
+		"return sum\n";
+
+	char const * const table_caller_script =
+		"local divide = ...\n"
+		"local sum = 0\n"
+		"for i = 1, 1000 do\n"
+		"    local result = divide(i, 7)\n"
+		"    sum = sum + result[1] + result[2]\n"
+		"end\n"
+		"return sum\n";
+
+	//the usual workaround for returning several values
+	struct division_table : lua::pushable
+	{
+		lua_Integer quotient;
+		lua_Integer remainder;
+
+		division_table(lua_Integer quotient, lua_Integer remainder) BOOST_NOEXCEPT
+			: quotient(quotient)
+			, remainder(remainder)
+		{
+		}
+
+		virtual void push(lua_State &L) const SILICIUM_OVERRIDE
+		{
+			lua_createtable(&L, 2, 0);
+			lua_pushinteger(&L, quotient);
+			lua_rawseti(&L, -2, 1);
+			lua_pushinteger(&L, remainder);
+			lua_rawseti(&L, -2, 2);
+		}
+	};
+
+	void run_script(char const *name, char const *script, lua::stack &s, lua::any_local const &divide)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range(script), "benchmark").value();
+		benchmark::run(name, 200, [&s, &compiled, &divide]()
+		{
+			std::array<lua::any_local, 1> const arguments = {{divide}};
+			lua::stack_value result = s.call(compiled, Si::make_container_source(arguments), lua::one());
+			BOOST_REQUIRE(get_integer(result));
+		});
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_multiple_results_tuple_vs_table)
+{
+	auto state = lua::create_lua();
+	lua::stack s(*state);
+	{
+		lua::stack_value divide = lua::register_any_function(s, [](lua_Integer dividend, lua_Integer divisor)
+		{
+			return std::make_tuple(dividend / divisor, dividend % divisor);
+		});
+		run_script("1000 calls returning a std::tuple", caller_script, s, divide);
+	}
+	{
+		lua::stack_value divide = lua::register_any_function(s, [](lua_Integer dividend, lua_Integer divisor)
+		{
+			return division_table(dividend / divisor, dividend % divisor);
+		});
+		run_script("1000 calls returning a table", table_caller_script, s, divide);
+	}
+}
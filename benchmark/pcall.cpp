@@ -0,0 +1,30 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/stack.hpp"
+#include "luacpp/load.hpp"
+
+BOOST_AUTO_TEST_CASE(benchmark_pcall_success_path)
+{
+	auto state = lua::create_lua();
+	lua_State &L = *state;
+	lua::stack_value function = lua::load_buffer(L, Si::make_c_str_range("local a, b = ... return a + b"), "benchmark").value();
+	std::size_t const repetitions = 1000000;
+	benchmark::run("lua_pcall without a message handler", repetitions, [&L, &function]()
+	{
+		lua_pushvalue(&L, function.from_bottom());
+		lua_pushinteger(&L, 1);
+		lua_pushinteger(&L, 2);
+		int const rc = lua_pcall(&L, 2, 1, 0);
+		BOOST_REQUIRE_EQUAL(0, rc);
+		lua_pop(&L, 1);
+	});
+	benchmark::run("pcall_with_traceback", repetitions, [&L, &function]()
+	{
+		lua_pushvalue(&L, function.from_bottom());
+		lua_pushinteger(&L, 1);
+		lua_pushinteger(&L, 2);
+		int const rc = lua::pcall_with_traceback(L, 2, 1);
+		BOOST_REQUIRE_EQUAL(0, rc);
+		lua_pop(&L, 1);
+	});
+}
@@ -0,0 +1,92 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/register_overloads.hpp"
+#include "luacpp/load.hpp"
+
+namespace
+{
+	lua::stack_value register_hand_written(lua::stack &s)
+	{
+		return lua::register_any_function(s, [](lua_State &L) -> lua_Number
+		{
+			switch (lua_gettop(&L))
+			{
+			case 1:
+				switch (lua_type(&L, 1))
+				{
+				case LUA_TNUMBER:
+					return lua_tonumber(&L, 1);
+
+				case LUA_TSTRING:
+					return static_cast<lua_Number>(lua_objlen(&L, 1));
+				}
+				break;
+
+			case 2:
+				if (lua_type(&L, 2) == LUA_TNUMBER)
+				{
+					return lua_tonumber(&L, 2);
+				}
+				break;
+			}
+			//not reached with the arguments of this benchmark
+			return 0;
+		});
+	}
+
+	lua::stack_value register_dispatched(lua::stack &s)
+	{
+		return lua::register_overloads(
+			s,
+			[](lua_Number number)
+			{
+				return number;
+			},
+			[](Si::memory_range text)
+			{
+				return static_cast<lua_Number>(text.size());
+			},
+			[](lua::any_local const &, lua_Number number)
+			{
+				return number;
+			}
+		);
+	}
+
+	void call_all_shapes(lua::stack &s, lua::stack_value const &loop, lua::stack_value const &function)
+	{
+		lua::push(*s.state(), loop);
+		lua::push(*s.state(), function);
+		lua_call(s.state(), 1, 0);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_register_overloads)
+{
+	auto state = lua::create_lua();
+	lua::stack s(*state);
+	lua::stack_value loop = lua::load_buffer(*state, Si::make_c_str_range(
+		"local f = ...\n"
+		"local t = {}\n"
+		"for i = 1, 1000 do\n"
+		"  f(i)\n"
+		"  f('text')\n"
+		"  f(t, i)\n"
+		"end\n"
+		), "benchmark").value();
+	std::size_t const repetitions = 1000;
+	{
+		lua::stack_value hand_written = register_hand_written(s);
+		benchmark::run("3000 calls of a hand-written switch over the Lua types", repetitions, [&s, &loop, &hand_written]()
+		{
+			call_all_shapes(s, loop, hand_written);
+		});
+	}
+	{
+		lua::stack_value dispatched = register_dispatched(s);
+		benchmark::run("3000 calls of register_overloads", repetitions, [&s, &loop, &dispatched]()
+		{
+			call_all_shapes(s, loop, dispatched);
+		});
+	}
+}
@@ -0,0 +1,57 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/state_pool.hpp"
+#include "luacpp/stack.hpp"
+#include "luacpp/load.hpp"
+
+namespace
+{
+	char const * const script =
+		"handlers = {}\n"
+		"for i = 1, 50 do\n"
+		"    handlers[\"handler\" .. i] = function (request) return string.format(\"%d: %s\", i, request) end\n"
+		"end\n"
+		"function handle(name, request)\n"
+		"    return handlers[name](request)\n"
+		"end\n";
+
+	void initialize(lua_State &L)
+	{
+		luaopen_base(&L);
+		luaopen_string(&L);
+		lua_settop(&L, 0);
+		lua::stack_value compiled = lua::load_buffer(L, Si::make_c_str_range(script), "benchmark").value();
+		lua::stack s(L);
+		s.call(compiled, lua::no_arguments(), 0);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_state_pool_cold_creation)
+{
+	benchmark::run("create and initialize a state", 5000, []()
+	{
+		auto state = lua::create_lua();
+		initialize(*state);
+	});
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_state_pool_acquire_release)
+{
+	lua::state_pool pool(initialize, 1);
+	benchmark::run("acquire and release a pooled state", 100000, [&pool]()
+	{
+		lua::pooled_state state = pool.acquire();
+		BOOST_REQUIRE(state.get());
+	});
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_state_pool_acquire_use_release)
+{
+	lua::state_pool pool(initialize, 1);
+	benchmark::run("acquire, define a global and release a pooled state", 100000, [&pool]()
+	{
+		lua::pooled_state state = pool.acquire();
+		lua_pushinteger(state.get(), 1);
+		lua_setglobal(state.get(), "request_local");
+	});
+}
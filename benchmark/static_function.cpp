@@ -0,0 +1,51 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/register_any_function.hpp"
+
+namespace
+{
+	lua_Integer add(lua_Integer left, lua_Integer right)
+	{
+		return left + right;
+	}
+
+	lua::stack_value register_add_closure(lua::stack &s)
+	{
+		return lua::register_any_function(s, [](lua_Integer left, lua_Integer right)
+		{
+			return add(left, right);
+		});
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_static_function)
+{
+	auto state = lua::create_lua();
+	lua::stack s(*state);
+	std::size_t const registrations = 100000;
+	benchmark::run("register_any_function", registrations, [&s]()
+	{
+		lua::stack_value function = register_add_closure(s);
+	});
+	benchmark::run("LUA_CPP_REGISTER_FUNCTION", registrations, [&s]()
+	{
+		lua::stack_value function = LUA_CPP_REGISTER_FUNCTION(*s.state(), add);
+	});
+
+	std::size_t const calls = 1000000;
+	std::array<lua_Integer, 2> const arguments = {{2, 3}};
+	{
+		lua::stack_value function = register_add_closure(s);
+		benchmark::run("call a function from register_any_function", calls, [&s, &function, &arguments]()
+		{
+			lua::stack_value result = s.call(function, Si::make_container_source(arguments), lua::one());
+		});
+	}
+	{
+		lua::stack_value function = LUA_CPP_REGISTER_FUNCTION(*s.state(), add);
+		benchmark::run("call a function from LUA_CPP_REGISTER_FUNCTION", calls, [&s, &function, &arguments]()
+		{
+			lua::stack_value result = s.call(function, Si::make_container_source(arguments), lua::one());
+		});
+	}
+}
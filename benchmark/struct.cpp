@@ -0,0 +1,66 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/struct.hpp"
+#include <boost/preprocessor/repetition/repeat.hpp>
+#include <boost/preprocessor/cat.hpp>
+#include <boost/concept_check.hpp>
+
+#define LUA_CPP_BENCHMARK_DECLARE_FIELD(z, n, data) lua_Integer BOOST_PP_CAT(field, n);
+#define LUA_CPP_BENCHMARK_FIELD_NAME(z, n, data) (BOOST_PP_CAT(field, n))
+#define LUA_CPP_BENCHMARK_SET_ELEMENT(z, n, data) lua::set_element(table, BOOST_PP_STRINGIZE(BOOST_PP_CAT(field, n)), value.BOOST_PP_CAT(field, n));
+
+#define LUA_CPP_BENCHMARK_STRUCT(name, count) \
+	namespace benchmark \
+	{ \
+		struct name \
+		{ \
+			BOOST_PP_REPEAT(count, LUA_CPP_BENCHMARK_DECLARE_FIELD, _) \
+		}; \
+		\
+		inline void push_by_hand(lua_State &L, name const &value) \
+		{ \
+			lua::stack_value table = lua::create_table(L); \
+			BOOST_PP_REPEAT(count, LUA_CPP_BENCHMARK_SET_ELEMENT, _) \
+			table.release(); \
+		} \
+	} \
+	LUA_CPP_STRUCT(benchmark::name, BOOST_PP_REPEAT(count, LUA_CPP_BENCHMARK_FIELD_NAME, _))
+
+LUA_CPP_BENCHMARK_STRUCT(fields_5, 5)
+LUA_CPP_BENCHMARK_STRUCT(fields_20, 20)
+LUA_CPP_BENCHMARK_STRUCT(fields_50, 50)
+
+namespace
+{
+	template <class Struct>
+	void compare_struct_conversions(char const *by_hand_name, char const *described_name, char const *from_lua_name)
+	{
+		auto state = lua::create_lua();
+		lua_State &L = *state;
+		Struct const value = Struct();
+		benchmark::run(by_hand_name, 100000, [&L, &value]()
+		{
+			push_by_hand(L, value);
+			lua_pop(&L, 1);
+		});
+		benchmark::run(described_name, 100000, [&L, &value]()
+		{
+			lua::push(L, value);
+			lua_pop(&L, 1);
+		});
+		lua::push(L, value);
+		lua::stack_value table(L, lua_gettop(&L));
+		benchmark::run(from_lua_name, 100000, [&table]()
+		{
+			Struct const converted = lua::from_lua_cast<Struct>(table);
+			boost::ignore_unused_variable_warning(converted);
+		});
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_struct_conversions)
+{
+	compare_struct_conversions<benchmark::fields_5>("push 5 fields with set_element", "push 5 fields with LUA_CPP_STRUCT", "from_lua 5 fields");
+	compare_struct_conversions<benchmark::fields_20>("push 20 fields with set_element", "push 20 fields with LUA_CPP_STRUCT", "from_lua 20 fields");
+	compare_struct_conversions<benchmark::fields_50>("push 50 fields with set_element", "push 50 fields with LUA_CPP_STRUCT", "from_lua 50 fields");
+}
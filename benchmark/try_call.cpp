@@ -0,0 +1,34 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/stack.hpp"
+#include "luacpp/load.hpp"
+
+BOOST_AUTO_TEST_CASE(benchmark_error_path_throwing_vs_error_code)
+{
+	auto state = lua::create_lua();
+	lua::stack s(*state);
+	luaopen_base(state.get());
+	lua_settop(state.get(), 0);
+	lua::stack_value compiled = lua::load_buffer(*state, Si::make_c_str_range(
+		"return function (input) if input < 0 then error('negative input', 0) end return input end"
+		), "benchmark").value();
+	lua::stack_value validate = s.call(compiled, lua::no_arguments(), lua::one());
+	std::array<lua_Integer, 1> const invalid = {{-1}};
+	std::size_t const repetitions = 100000;
+	benchmark::run("failing stack::call with an exception", repetitions, [&s, &validate, &invalid]()
+	{
+		try
+		{
+			s.call(validate, Si::make_container_source(invalid), 1);
+			BOOST_FAIL("an exception was expected");
+		}
+		catch (lua::lua_exception const &)
+		{
+		}
+	});
+	benchmark::run("failing stack::try_call", repetitions, [&s, &validate, &invalid]()
+	{
+		lua::call_result result = s.try_call(validate, Si::make_container_source(invalid), 1);
+		BOOST_REQUIRE(result.error);
+	});
+}
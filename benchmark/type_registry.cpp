@@ -0,0 +1,49 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/meta_table.hpp"
+#include "luacpp/register_closure.hpp"
+
+namespace
+{
+	struct connection
+	{
+		lua_Integer id;
+
+		lua_Integer get_id() const
+		{
+			return id;
+		}
+	};
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_type_registry)
+{
+	auto state = lua::create_lua();
+	lua::stack s(*state);
+	std::size_t const repetitions = 100000;
+	benchmark::run("create an object with a new meta table", repetitions, [&s]()
+	{
+		lua::stack_value meta = lua::create_table(*s.state());
+		lua::detail::fill_default_meta_table<connection>(s, meta);
+		lua::add_method(s, meta, "get_id", &connection::get_id);
+		lua::stack_value object = lua::emplace_object<connection>(s, meta, 1);
+		lua::replace(object, meta);
+	});
+	benchmark::run("create an object with the registered meta table", repetitions, [&s]()
+	{
+		lua::stack_value meta = lua::create_default_meta_table<connection>(s, [&s](lua::stack_value &table)
+		{
+			lua::add_method(s, table, "get_id", &connection::get_id);
+		});
+		lua::stack_value object = lua::emplace_object<connection>(s, meta, 1);
+		lua::replace(object, meta);
+	});
+	benchmark::run("register_closure", repetitions, [&s]()
+	{
+		lua::stack_value closure = lua::register_closure(s, [](lua_State *) -> lua::result_or_yield
+		{
+			return 0;
+		});
+	});
+	lua_gc(state.get(), LUA_GCCOLLECT, 0);
+}
@@ -0,0 +1,28 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/from_lua_cast.hpp"
+#include "luacpp/load.hpp"
+
+BOOST_AUTO_TEST_CASE(benchmark_typed_call)
+{
+	auto state = lua::create_lua();
+	lua::stack s(*state);
+	lua::stack_value compiled = lua::load_buffer(*state, Si::make_c_str_range(
+		"return function (a, b) return a + b, a * b end"
+		), "benchmark").value();
+	lua::stack_value function = s.call(compiled, lua::no_arguments(), lua::one());
+	std::size_t const repetitions = 1000000;
+	benchmark::run("stack::call with a source and a stack_array", repetitions, [&s, &function]()
+	{
+		std::array<lua_Number, 2> const arguments = {{2, 3}};
+		lua::stack_array results = s.call(function, Si::make_container_source(arguments), 2);
+		lua_Number const sum = lua::from_lua_cast<lua_Number>(lua::at(results, 0));
+		lua_Number const product = lua::from_lua_cast<lua_Number>(lua::at(results, 1));
+		BOOST_REQUIRE_EQUAL(11, sum + product);
+	});
+	benchmark::run("stack::call<lua_Number, lua_Number>", repetitions, [&s, &function]()
+	{
+		std::tuple<lua_Number, lua_Number> const results = s.call<lua_Number, lua_Number>(function, 2.0, 3.0);
+		BOOST_REQUIRE_EQUAL(11, std::get<0>(results) + std::get<1>(results));
+	});
+}
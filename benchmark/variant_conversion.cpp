@@ -0,0 +1,69 @@
+#include <boost/test/unit_test.hpp>
+#include "measure.hpp"
+#include "luacpp/from_lua_cast.hpp"
+
+namespace
+{
+	typedef Si::fast_variant<lua_Integer, Si::memory_range, bool, Si::noexcept_string> variant;
+
+	//the previous implementation which converted every alternative until the type matched
+	struct sequential_converter
+	{
+		variant operator()(lua_State &L, int address) const
+		{
+			static std::array<std::pair<variant, bool> (*)(lua_State &, int), 4> const converters =
+			{{
+				&try_convert<lua_Integer>,
+				&try_convert<Si::memory_range>,
+				&try_convert<bool>,
+				&try_convert<Si::noexcept_string>
+			}};
+			std::pair<variant, bool> result = converters[0](L, address);
+			for (auto const &converter : converters)
+			{
+				if (result.second)
+				{
+					break;
+				}
+				result = converter(L, address);
+			}
+			return std::move(result.first);
+		}
+
+	private:
+
+		template <class To>
+		static std::pair<variant, bool> try_convert(lua_State &L, int address)
+		{
+			bool const is_correct_type = (lua::from_lua<To>::lua_type == static_cast<lua::type>(lua_type(&L, address)));
+			return std::make_pair(variant(lua::from_lua<To>()(L, address)), is_correct_type);
+		}
+	};
+
+	template <class Converter>
+	void convert_fragments(char const *name, lua_State &L, lua::any_local const &integer, lua::any_local const &fragment, lua::any_local const &flag)
+	{
+		benchmark::run(name, 1000000, [&L, &integer, &fragment, &flag]()
+		{
+			Converter const convert;
+			variant const first = convert(L, integer.from_bottom());
+			variant const second = convert(L, fragment.from_bottom());
+			variant third = convert(L, flag.from_bottom());
+			BOOST_REQUIRE(Si::try_get_ptr<bool>(third));
+		});
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_variant_conversion)
+{
+	auto state = lua::create_lua();
+	lua_State &L = *state;
+	lua::push(L, static_cast<lua_Integer>(123));
+	lua::stack_value integer(L, lua_gettop(&L));
+	lua::push(L, "a fragment of the response that is long enough to not fit into a small string buffer");
+	lua::stack_value fragment(L, lua_gettop(&L));
+	lua::push(L, true);
+	lua::stack_value flag(L, lua_gettop(&L));
+	convert_fragments<sequential_converter>("convert by trying every alternative", L, integer, fragment, flag);
+	convert_fragments<lua::from_lua<variant>>("convert with the type table", L, integer, fragment, flag);
+}
@@ -0,0 +1,71 @@
+#include "luacpp/bundle.hpp"
+#include <boost/program_options.hpp>
+#include <iostream>
+
+namespace
+{
+	struct options
+	{
+		std::string directory;
+		std::string output;
+		unsigned threads;
+	};
+
+	boost::optional<options> parse_options(int argc, char **argv)
+	{
+		options parsed;
+
+		boost::program_options::options_description desc("Allowed options");
+		desc.add_options()
+		    ("help", "produce help message")
+			("directory", boost::program_options::value(&parsed.directory), "the directory containing the .lua files")
+			("output", boost::program_options::value(&parsed.output)->default_value("scripts.bundle"), "the bundle file to create")
+			("threads", boost::program_options::value(&parsed.threads)->default_value(std::thread::hardware_concurrency()), "the number of compiler threads")
+		;
+
+		boost::program_options::positional_options_description positional;
+		positional.add("directory", 1);
+		boost::program_options::variables_map vm;
+		try
+		{
+			boost::program_options::store(boost::program_options::command_line_parser(argc, argv).options(desc).positional(positional).run(), vm);
+		}
+		catch (boost::program_options::error const &ex)
+		{
+			std::cerr
+				<< ex.what() << '\n'
+				<< desc << "\n";
+			return boost::none;
+		}
+
+		boost::program_options::notify(vm);
+
+		if (vm.count("help") || parsed.directory.empty())
+		{
+		    std::cerr << desc << "\n";
+		    return boost::none;
+		}
+
+		return parsed;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	boost::optional<options> parsed_options = parse_options(argc, argv);
+	if (!parsed_options)
+	{
+		return 1;
+	}
+	try
+	{
+		lua::bytecode_bundle const bundle = lua::compile_directory(parsed_options->directory, parsed_options->threads);
+		lua::write_bundle(parsed_options->output, bundle);
+		std::cerr << "Compiled " << bundle.size() << " scripts into " << parsed_options->output << '\n';
+	}
+	catch (std::exception const &ex)
+	{
+		std::cerr << ex.what() << '\n';
+		return 1;
+	}
+}
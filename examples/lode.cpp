@@ -1,11 +1,13 @@
 #include "luacpp/observable_from_lua.hpp"
 #include "luacpp/meta_table.hpp"
 #include "luacpp/sink_into_lua.hpp"
+#include "luacpp/key_cache.hpp"
 #include "luacpp/pcall.hpp"
 #include "luacpp/sink_from_lua.hpp"
 #include "luacpp/load.hpp"
 #include "luacpp/register_async_function.hpp"
 #include "luacpp/observable_into_lua.hpp"
+#include "luacpp/string_view.hpp"
 #include <silicium/asio/tcp_acceptor.hpp>
 #include <silicium/asio/writing_observable.hpp>
 #include <silicium/asio/timer.hpp>
@@ -99,15 +101,12 @@ namespace
 #ifndef NDEBUG
 		int initial_stack_size = lua::size(*s.state());
 #endif
-		lua::stack_value meta = lua::create_default_meta_table<tcp_client>(s);
-		assert(lua::size(*s.state()) == initial_stack_size + 1);
-		assert(get_type(meta) == lua::type::table);
-
-		add_method(s, meta, "append", &tcp_client::append);
-		assert(lua::size(*s.state()) == initial_stack_size + 1);
-		assert(get_type(meta) == lua::type::table);
-
-		lua::add_method(s, meta, "flush", &tcp_client::flush);
+		//the table is created for the first connection only
+		lua::stack_value meta = lua::create_default_meta_table<tcp_client>(s, [&s](lua::stack_value &table)
+		{
+			add_method(s, table, "append", &tcp_client::append);
+			lua::add_method(s, table, "flush", &tcp_client::flush);
+		});
 		assert(lua::size(*s.state()) == initial_stack_size + 1);
 		assert(get_type(meta) == lua::type::table);
 		return meta;
@@ -115,27 +114,30 @@ namespace
 
 	struct http_response_generator
 	{
-		explicit http_response_generator(lua::reference sink)
+		//keys[0] is "append"
+		explicit http_response_generator(lua::reference sink, std::shared_ptr<lua::key_cache const> keys)
 			: m_sink(std::move(sink))
+			, m_keys(std::move(keys))
 		{
+			assert(m_keys);
 			assert(m_sink.get_type() == lua::type::user_data);
 		}
 
 		void status_line(Si::memory_range status, Si::memory_range status_text, Si::memory_range version, lua_State &state)
 		{
-			lua::text_sink_into_lua native_sink(m_sink, state);
+			lua::text_sink_into_lua native_sink(m_sink, state, (*m_keys)[0]);
 			Si::http::generate_status_line(native_sink, version, status, status_text);
 		}
 
 		void header(Si::memory_range key, Si::memory_range value, lua_State &state)
 		{
-			lua::text_sink_into_lua native_sink(m_sink, state);
+			lua::text_sink_into_lua native_sink(m_sink, state, (*m_keys)[0]);
 			Si::http::generate_header(native_sink, key, value);
 		}
 
 		void content(Si::memory_range content, lua_State &state)
 		{
-			lua::text_sink_into_lua native_sink(m_sink, state);
+			lua::text_sink_into_lua native_sink(m_sink, state, (*m_keys)[0]);
 			Si::append(native_sink, "\r\n");
 			native_sink.append(content);
 		}
@@ -143,6 +145,7 @@ namespace
 	private:
 
 		lua::reference m_sink;
+		std::shared_ptr<lua::key_cache const> m_keys;
 	};
 
 	inline std::chrono::microseconds lua_duration_to_cpp(lua_Number duration_seconds)
@@ -155,8 +158,8 @@ namespace
 		lua::main_thread main_thread,
 		lua::stack &stack,
 		boost::asio::io_service &io,
-		Si::noexcept_string const &name,
-		Si::noexcept_string const &version)
+		lua::string_view name,
+		lua::string_view version)
 	{
 		if (name == "tcp" && version == "1.0")
 		{
@@ -196,24 +199,27 @@ namespace
 		else if (name == "http" && version == "1.0")
 		{
 			lua::stack_value module = lua::create_table(*stack.state());
+			auto keys = std::make_shared<lua::key_cache>(main_thread, std::initializer_list<char const *>{"append"});
 			set_element(
 				module,
 				"make_response_generator",
-				[main_thread, &stack, &io](lua_State &)
+				[main_thread, &stack, &io, keys](lua_State &)
 			{
-				return lua::register_any_function(stack, [main_thread, &io](lua::any_local const &sink, lua_State &L)
+				return lua::register_any_function(stack, [main_thread, &io, keys](lua::any_local const &sink, lua_State &L)
 				{
 					assert(sink.get_type() == lua::type::user_data);
 					lua::stack s(L);
-					lua::stack_value meta = lua::create_default_meta_table<http_response_generator>(s);
-					lua::add_method(s, meta, "status_line", &http_response_generator::status_line);
-					lua::add_method(s, meta, "header", &http_response_generator::header);
-					lua::add_method(s, meta, "content", &http_response_generator::content);
+					lua::stack_value meta = lua::create_default_meta_table<http_response_generator>(s, [&s](lua::stack_value &table)
+					{
+						lua::add_method(s, table, "status_line", &http_response_generator::status_line);
+						lua::add_method(s, table, "header", &http_response_generator::header);
+						lua::add_method(s, table, "content", &http_response_generator::content);
+					});
 
 					lua::reference sink_kept_alive = lua::create_reference(main_thread, sink);
 					assert(sink_kept_alive.get_type() == lua::type::user_data);
 
-					lua::stack_value generator = lua::emplace_object<http_response_generator>(s, meta, std::move(sink_kept_alive));
+					lua::stack_value generator = lua::emplace_object<http_response_generator>(s, meta, std::move(sink_kept_alive), keys);
 					lua::replace(generator, meta);
 					return generator;
 				});
@@ -382,7 +388,7 @@ int main(int argc, char **argv)
 				lua::xmove(std::move(second_level), runner.thread()),
 				Si::make_oneshot_generator_source([main_thread, &runner_stack, &io]()
 			{
-				return lua::register_any_function(runner_stack, [main_thread, &runner_stack, &io](Si::noexcept_string const &name, Si::noexcept_string const &version)
+				return lua::register_any_function(runner_stack, [main_thread, &runner_stack, &io](lua::string_view name, lua::string_view version)
 				{
 					return require_package(main_thread, runner_stack, io, name, version);
 				});
@@ -0,0 +1,113 @@
+#ifndef LUACPP_ACCOUNTING_ALLOCATOR_HPP
+#define LUACPP_ACCOUNTING_ALLOCATOR_HPP
+
+#include "luacpp/stack.hpp"
+#include <boost/noncopyable.hpp>
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace lua
+{
+	struct memory_statistics
+	{
+		static std::size_t const bucket_count = 20;
+
+		std::size_t live_bytes;
+		std::size_t peak_bytes;
+
+		///number of successful requests for a new or resized block
+		std::size_t allocation_count;
+
+		///size_histogram[i] counts the allocations of more than 2^(i-1) and at most 2^i bytes.
+		///The last bucket also counts everything bigger.
+		std::array<std::size_t, bucket_count> size_histogram;
+
+		memory_statistics() BOOST_NOEXCEPT
+			: live_bytes(0)
+			, peak_bytes(0)
+			, allocation_count(0)
+		{
+			size_histogram.fill(0);
+		}
+
+		static std::size_t bucket(std::size_t size) BOOST_NOEXCEPT
+		{
+			std::size_t index = 0;
+			while ((index + 1) < bucket_count && (static_cast<std::size_t>(1) << index) < size)
+			{
+				++index;
+			}
+			return index;
+		}
+	};
+
+	///Keeps track of the memory used by a lua_State and enforces an upper limit.
+	///An allocation that would exceed the limit fails, which makes Lua raise LUA_ERRMEM (lua::error::mem).
+	///Shrinking a block never fails because Lua does not expect that.
+	template <class Underlying = default_allocator>
+	struct accounting_allocator : private boost::noncopyable
+	{
+		explicit accounting_allocator(std::size_t limit = (std::numeric_limits<std::size_t>::max)()) BOOST_NOEXCEPT
+			: m_limit(limit)
+		{
+		}
+
+		memory_statistics const &statistics() const BOOST_NOEXCEPT
+		{
+			return m_statistics;
+		}
+
+		std::size_t limit() const BOOST_NOEXCEPT
+		{
+			return m_limit;
+		}
+
+		///A limit below the current usage only prevents further growth.
+		void set_limit(std::size_t limit) BOOST_NOEXCEPT
+		{
+			m_limit = limit;
+		}
+
+		Underlying &underlying() BOOST_NOEXCEPT
+		{
+			return m_underlying;
+		}
+
+		void *reallocate(void *block, std::size_t old_size, std::size_t new_size) BOOST_NOEXCEPT
+		{
+			assert(old_size <= m_statistics.live_bytes);
+			if (new_size > old_size)
+			{
+				std::size_t const growth = new_size - old_size;
+				if ((m_statistics.live_bytes >= m_limit) ||
+					(growth > (m_limit - m_statistics.live_bytes)))
+				{
+					return nullptr;
+				}
+			}
+			void * const result = m_underlying.reallocate(block, old_size, new_size);
+			if (!result && (new_size != 0))
+			{
+				return nullptr;
+			}
+			m_statistics.live_bytes -= old_size;
+			m_statistics.live_bytes += new_size;
+			m_statistics.peak_bytes = (std::max)(m_statistics.peak_bytes, m_statistics.live_bytes);
+			if (new_size != 0)
+			{
+				++m_statistics.allocation_count;
+				++m_statistics.size_histogram[memory_statistics::bucket(new_size)];
+			}
+			return result;
+		}
+
+	private:
+
+		Underlying m_underlying;
+		std::size_t m_limit;
+		memory_statistics m_statistics;
+	};
+}
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef LUACPP_BOX_HPP
+#define LUACPP_BOX_HPP
+
+#include "luacpp/meta_table.hpp"
+#include "luacpp/register_closure.hpp"
+#include <limits>
+
+namespace lua
+{
+	namespace detail
+	{
+		///Copies the meta table registered for T into the meta table of a box. References of the original table to
+		///itself (like the default __index) refer to the copy instead. The __gc of T is never copied.
+		template <class T>
+		void copy_meta_table_for_box(stack &s, stack_value &copy)
+		{
+			lua_State &L = *s.state();
+			stack_value original = create_default_meta_table<T>(s);
+			lua_pushnil(&L);
+			while (lua_next(&L, original.from_bottom()))
+			{
+				if (lua_rawequal(&L, -1, original.from_bottom()))
+				{
+					lua_pop(&L, 1);
+					lua_pushvalue(&L, copy.from_bottom());
+				}
+				//key, value -> key, key, value
+				lua_pushvalue(&L, -2);
+				lua_insert(&L, -2);
+				lua_rawset(&L, copy.from_bottom());
+			}
+			lua_pushliteral(&L, "__gc");
+			lua_pushnil(&L);
+			lua_rawset(&L, copy.from_bottom());
+		}
+
+		///The memory that the objects of shared boxes own outside of the Lua heap. There is one per state, stored in
+		///the registry.
+		struct external_memory
+		{
+			std::size_t live;
+
+			///the value of live when the collector did the last step because of external memory
+			std::size_t reported;
+		};
+
+		///External memory has to grow by this many bytes before the collector does a step.
+		BOOST_CONSTEXPR_OR_CONST std::size_t external_memory_step = 1024 * 1024;
+
+		///returns nullptr if nothing has been pushed with push_shared in this state yet
+		inline external_memory *find_external_memory(lua_State &L) BOOST_NOEXCEPT
+		{
+			push_registered(L, type_key<external_memory>());
+			void * const counter = lua_touserdata(&L, -1);
+			lua_pop(&L, 1);
+			return static_cast<external_memory *>(counter);
+		}
+
+		inline external_memory &get_external_memory(lua_State &L)
+		{
+			if (external_memory * const existing = find_external_memory(L))
+			{
+				return *existing;
+			}
+			//the registry keeps the user data alive, so the pointer stays valid after the pop
+			void * const created = lua_newuserdata(&L, sizeof(external_memory));
+			external_memory * const counter = new (created) external_memory{0, 0};
+			lua_pushlightuserdata(&L, type_key<external_memory>());
+			lua_insert(&L, -2);
+			lua_rawset(&L, LUA_REGISTRYINDEX);
+			return *counter;
+		}
+
+		///Lua 5.1 does not know about memory outside of its heap. Instead of a step for every object, the sizes are
+		///added up and the collector is told about them in one step once they have grown by external_memory_step.
+		inline void add_external_memory(lua_State &L, external_memory &counter, std::size_t size)
+		{
+			counter.live += size;
+			assert(counter.live >= counter.reported);
+			std::size_t const unreported = counter.live - counter.reported;
+			if (unreported < external_memory_step)
+			{
+				return;
+			}
+			counter.reported = counter.live;
+			std::size_t const kilobytes = (std::min)(unreported / 1024, static_cast<std::size_t>((std::numeric_limits<int>::max)()));
+			lua_gc(&L, LUA_GCSTEP, static_cast<int>(kilobytes));
+		}
+
+		inline void remove_external_memory(lua_State &L, std::size_t size) BOOST_NOEXCEPT
+		{
+			external_memory * const counter = find_external_memory(L);
+			if (!counter)
+			{
+				//reset_to_baseline may have removed the counter from the registry
+				return;
+			}
+			counter->live -= (std::min)(counter->live, size);
+			counter->reported = (std::min)(counter->reported, counter->live);
+		}
+
+		template <class T>
+		int delete_shared_box(lua_State *L) BOOST_NOEXCEPT
+		{
+			shared_box<T> * const box = static_cast<shared_box<T> *>(lua_touserdata(L, 1));
+			assert(box);
+			remove_external_memory(*L, box->external_size);
+			box->~shared_box<T>();
+			return 0;
+		}
+
+		///Methods and properties have to be added to the meta table of T before the first box of T is pushed,
+		///because the copy is created only once per state.
+		template <class T>
+		stack_value get_shared_box_meta_table(stack &s)
+		{
+			return get_or_create_meta_table(*s.state(), type_key<shared_box<T>>(), [&s](stack_value &meta)
+			{
+				copy_meta_table_for_box<T>(s, meta);
+				stack_value destructor = register_function(*s.state(), delete_shared_box<T>);
+				set_element(meta, "__gc", destructor);
+			});
+		}
+
+		template <class T>
+		stack_value get_borrowed_box_meta_table(stack &s)
+		{
+			//a borrowed box is trivially destructible, so it does not need a __gc
+			return get_or_create_meta_table(*s.state(), type_key<borrowed_box<T>>(), [&s](stack_value &meta)
+			{
+				copy_meta_table_for_box<T>(s, meta);
+			});
+		}
+	}
+
+	///Makes an object that is owned by a shared_ptr available to Lua without copying or moving it into the Lua heap.
+	///The user data holds only the shared_ptr and has the methods and properties of the meta table of T, so
+	///add_method and class_builder work as for objects created with emplace_object. Use to_object<T> to get the object.
+	///'external_size' is the memory that the object owns outside of the Lua heap. It is counted per state until the box
+	///is collected, and the collector does a step whenever the count has grown by detail::external_memory_step bytes
+	///(see detail::add_external_memory). Pass 0 for an object whose memory does not matter.
+	template <class T>
+	stack_value push_shared(stack &s, std::shared_ptr<T> object, std::size_t external_size = sizeof(T))
+	{
+		assert(object);
+		typedef detail::shared_box<T> box;
+		detail::external_memory &external = detail::get_external_memory(*s.state());
+		stack_value meta = detail::get_shared_box_meta_table<T>(s);
+		stack_value data = create_user_data(*s.state(), sizeof(box));
+		box * const raw_box = new (to_user_data(data)) box{std::move(object), external_size};
+		try
+		{
+			set_meta_table(data, meta);
+		}
+		catch (...)
+		{
+			raw_box->~box();
+			throw;
+		}
+		replace(data, meta);
+		detail::add_external_memory(*s.state(), external, external_size);
+		return data;
+	}
+
+	///Like push_shared for an object that outlives every use of the user data in Lua. The object is not destroyed
+	///when the user data is collected.
+	template <class T>
+	stack_value push_borrowed(stack &s, T &object)
+	{
+		typedef detail::borrowed_box<T> box;
+		stack_value meta = detail::get_borrowed_box_meta_table<T>(s);
+		stack_value data = create_user_data(*s.state(), sizeof(box));
+		//a borrowed box is trivially destructible, so there is nothing to clean up if setting the meta table fails
+		new (to_user_data(data)) box{&object};
+		set_meta_table(data, meta);
+		replace(data, meta);
+		return data;
+	}
+}
+
+#endif
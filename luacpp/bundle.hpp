@@ -0,0 +1,220 @@
+#ifndef LUACPP_BUNDLE_HPP
+#define LUACPP_BUNDLE_HPP
+
+#include "luacpp/bytecode_cache.hpp"
+#include "luacpp/load_mapped_file.hpp"
+#include "luacpp/state.hpp"
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/cstdint.hpp>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace lua
+{
+	///Compiled chunks by name. Names are paths relative to the compiled directory with / as the separator.
+	typedef std::map<std::string, std::vector<char>> bytecode_bundle;
+
+	///Compiles every .lua file below 'root' into bytecode. Each of the 'thread_count' workers uses its own state.
+	///Throws lua_exception for the first script that fails to compile.
+	inline bytecode_bundle compile_directory(boost::filesystem::path const &root, unsigned thread_count = std::thread::hardware_concurrency())
+	{
+		std::vector<boost::filesystem::path> scripts;
+		for (boost::filesystem::recursive_directory_iterator i(root), end; i != end; ++i)
+		{
+			if (boost::filesystem::is_regular_file(i->status()) && (i->path().extension() == ".lua"))
+			{
+				scripts.emplace_back(i->path());
+			}
+		}
+
+		std::vector<std::vector<char>> compiled(scripts.size());
+		std::atomic<std::size_t> next_script(0);
+		std::mutex error_mutex;
+		std::exception_ptr first_error;
+		auto const work = [&]()
+		{
+			try
+			{
+				state_ptr state = create_lua();
+				for (;;)
+				{
+					std::size_t const index = next_script++;
+					if (index >= scripts.size())
+					{
+						break;
+					}
+					stack_value function = load_mapped_file(*state, scripts[index]).value();
+					compiled[index] = dump(*state, function);
+				}
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(error_mutex);
+				if (!first_error)
+				{
+					first_error = std::current_exception();
+				}
+				//let the other workers stop early
+				next_script = scripts.size();
+			}
+		};
+		std::vector<std::thread> workers;
+		std::size_t const worker_count = (std::min<std::size_t>)((std::max)(thread_count, 1u), scripts.size());
+		for (std::size_t i = 1; i < worker_count; ++i)
+		{
+			workers.emplace_back(work);
+		}
+		work();
+		for (std::thread &worker : workers)
+		{
+			worker.join();
+		}
+		if (first_error)
+		{
+			std::rethrow_exception(first_error);
+		}
+
+		std::string prefix = root.generic_string();
+		if (!prefix.empty() && (prefix.back() != '/'))
+		{
+			prefix += '/';
+		}
+		bytecode_bundle bundle;
+		for (std::size_t i = 0; i < scripts.size(); ++i)
+		{
+			std::string const full_name = scripts[i].generic_string();
+			assert(full_name.compare(0, prefix.size(), prefix) == 0);
+			bundle.emplace(full_name.substr(prefix.size()), std::move(compiled[i]));
+		}
+		return bundle;
+	}
+
+	namespace detail
+	{
+		static char const bundle_magic[8] = {'l', 'u', 'a', 'c', 'p', 'p', 'B', 'N'};
+	}
+
+	///The file starts with a magic number and the number of chunks, followed by the index (name size, name, offset, size)
+	///and the bytecode of all chunks. Offsets are relative to the beginning of the file.
+	inline void write_bundle(boost::filesystem::path const &file, bytecode_bundle const &bundle)
+	{
+		std::vector<char> index;
+		boost::uint64_t data_offset = sizeof(detail::bundle_magic) + sizeof(boost::uint64_t);
+		for (auto const &chunk : bundle)
+		{
+			data_offset += sizeof(boost::uint64_t) * 3 + chunk.first.size();
+		}
+		detail::append_integer(index, static_cast<boost::uint64_t>(bundle.size()));
+		for (auto const &chunk : bundle)
+		{
+			detail::append_integer(index, static_cast<boost::uint64_t>(chunk.first.size()));
+			index.insert(index.end(), chunk.first.begin(), chunk.first.end());
+			detail::append_integer(index, data_offset);
+			detail::append_integer(index, static_cast<boost::uint64_t>(chunk.second.size()));
+			data_offset += chunk.second.size();
+		}
+		boost::filesystem::ofstream out(file, std::ios::binary);
+		out.write(detail::bundle_magic, sizeof(detail::bundle_magic));
+		out.write(index.data(), static_cast<std::streamsize>(index.size()));
+		for (auto const &chunk : bundle)
+		{
+			out.write(chunk.second.data(), static_cast<std::streamsize>(chunk.second.size()));
+		}
+		out.close();
+		if (!out)
+		{
+			boost::throw_exception(std::runtime_error("Could not write the bundle " + to_utf8(file)));
+		}
+	}
+
+	///A bundle file mapped into memory. Chunks are loaded by name without touching the original scripts.
+	struct bundle_file
+	{
+		bundle_file()
+		{
+		}
+
+		explicit bundle_file(boost::filesystem::path const &file)
+			: m_mapped(file)
+		{
+			Si::memory_range content = Si::make_memory_range(m_mapped.data(), m_mapped.data() + m_mapped.size());
+			boost::uint64_t count = 0;
+			if ((static_cast<std::size_t>(content.size()) < sizeof(detail::bundle_magic)) ||
+				!std::equal(detail::bundle_magic, detail::bundle_magic + sizeof(detail::bundle_magic), content.begin()))
+			{
+				throw_invalid(file);
+			}
+			content = Si::make_memory_range(content.begin() + sizeof(detail::bundle_magic), content.end());
+			if (!detail::read_integer(content, count))
+			{
+				throw_invalid(file);
+			}
+			for (boost::uint64_t i = 0; i < count; ++i)
+			{
+				boost::uint64_t name_size = 0, offset = 0, size = 0;
+				if (!detail::read_integer(content, name_size) ||
+					(static_cast<boost::uint64_t>(content.size()) < name_size))
+				{
+					throw_invalid(file);
+				}
+				std::string name(content.begin(), content.begin() + name_size);
+				content = Si::make_memory_range(content.begin() + name_size, content.end());
+				if (!detail::read_integer(content, offset) ||
+					!detail::read_integer(content, size) ||
+					(offset > m_mapped.size()) ||
+					(size > (m_mapped.size() - offset)))
+				{
+					throw_invalid(file);
+				}
+				m_index.emplace(std::move(name), Si::make_memory_range(m_mapped.data() + offset, m_mapped.data() + offset + size));
+			}
+		}
+
+		std::size_t size() const BOOST_NOEXCEPT
+		{
+			return m_index.size();
+		}
+
+		Si::optional<Si::memory_range> find(std::string const &name) const
+		{
+			auto const found = m_index.find(name);
+			if (found == m_index.end())
+			{
+				return Si::none;
+			}
+			return found->second;
+		}
+
+	private:
+
+		boost::iostreams::mapped_file_source m_mapped;
+		std::map<std::string, Si::memory_range> m_index;
+
+		static void throw_invalid(boost::filesystem::path const &file)
+		{
+			boost::throw_exception(std::runtime_error("Invalid bundle file " + to_utf8(file)));
+		}
+	};
+
+	///Loads the chunk with the given name from a bundle. A missing name results in lua::error::file.
+	SILICIUM_USE_RESULT
+	inline result load_from_bundle(lua_State &stack, bundle_file const &bundle, std::string const &name)
+	{
+		std::string const chunk_name = "@" + name;
+		Si::optional<Si::memory_range> const bytecode = bundle.find(name);
+		if (!bytecode)
+		{
+			lua_pushfstring(&stack, "cannot find %s in the bundle", name.c_str());
+			stack_value error(stack, lua_gettop(&stack));
+			return result(LUA_ERRFILE, std::move(error));
+		}
+		return load_buffer(stack, *bytecode, chunk_name.c_str());
+	}
+}
+
+#endif
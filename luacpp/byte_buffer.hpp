@@ -0,0 +1,204 @@
+#ifndef LUACPP_BYTE_BUFFER_HPP
+#define LUACPP_BYTE_BUFFER_HPP
+
+#include "luacpp/type_registry.hpp"
+#include <silicium/memory_range.hpp>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace lua
+{
+	///Bytes that are passed to Lua as a userdata instead of a string, so they are neither copied nor hashed.
+	///Lua code can use buffer:len(), #buffer, buffer:sub(i, j), buffer:byte(i, j) and buffer:tostring() which
+	///behave like the corresponding string functions. sub does not copy either.
+	struct byte_buffer
+	{
+		Si::memory_range content;
+
+		///keeps the content alive, can be empty if the owner of the memory makes sure that it outlives the buffer
+		std::shared_ptr<void const> owner;
+
+		byte_buffer() BOOST_NOEXCEPT
+		{
+		}
+
+		byte_buffer(Si::memory_range content, std::shared_ptr<void const> owner) BOOST_NOEXCEPT
+			: content(content)
+			, owner(std::move(owner))
+		{
+		}
+	};
+
+	///The content will be owned by the buffer and its sub-buffers.
+	inline byte_buffer make_byte_buffer(std::vector<char> content)
+	{
+		auto owner = std::make_shared<std::vector<char>>(std::move(content));
+		Si::memory_range const range = Si::make_memory_range(*owner);
+		return byte_buffer(range, std::move(owner));
+	}
+
+	namespace detail
+	{
+		///returns nullptr if the value is not a byte_buffer
+		inline byte_buffer *to_byte_buffer(lua_State &L, int address) BOOST_NOEXCEPT
+		{
+			if (::lua_type(&L, address) != LUA_TUSERDATA)
+			{
+				return nullptr;
+			}
+			void * const user_data = lua_touserdata(&L, address);
+			if (!lua_getmetatable(&L, address))
+			{
+				return nullptr;
+			}
+			bool const is_buffer = is_registered_meta_table(L, type_key<byte_buffer>());
+			lua_pop(&L, 1);
+			return is_buffer ? static_cast<byte_buffer *>(user_data) : nullptr;
+		}
+
+		inline byte_buffer &check_byte_buffer(lua_State *L)
+		{
+			byte_buffer * const buffer = to_byte_buffer(*L, 1);
+			if (!buffer)
+			{
+				//does not return
+				luaL_typerror(L, 1, "byte_buffer");
+			}
+			return *buffer;
+		}
+
+		///converts a one-based, possibly negative position like string.sub does
+		inline lua_Integer relative_position(lua_Integer position, std::size_t length) BOOST_NOEXCEPT
+		{
+			if (position < 0)
+			{
+				position += static_cast<lua_Integer>(length) + 1;
+			}
+			return (position >= 0) ? position : 0;
+		}
+
+		inline void emplace_byte_buffer(lua_State &L, Si::memory_range content, std::shared_ptr<void const> const &owner);
+
+		inline int byte_buffer_gc(lua_State *L)
+		{
+			byte_buffer &buffer = check_byte_buffer(L);
+			buffer.~byte_buffer();
+			return 0;
+		}
+
+		inline int byte_buffer_len(lua_State *L)
+		{
+			byte_buffer &buffer = check_byte_buffer(L);
+			lua_pushinteger(L, static_cast<lua_Integer>(buffer.content.size()));
+			return 1;
+		}
+
+		inline int byte_buffer_tostring(lua_State *L)
+		{
+			byte_buffer &buffer = check_byte_buffer(L);
+			lua_pushlstring(L, buffer.content.begin(), static_cast<std::size_t>(buffer.content.size()));
+			return 1;
+		}
+
+		inline int byte_buffer_sub(lua_State *L)
+		{
+			byte_buffer &buffer = check_byte_buffer(L);
+			std::size_t const length = static_cast<std::size_t>(buffer.content.size());
+			lua_Integer first = relative_position(luaL_checkinteger(L, 2), length);
+			lua_Integer last = relative_position(luaL_optinteger(L, 3, -1), length);
+			if (first < 1)
+			{
+				first = 1;
+			}
+			if (last > static_cast<lua_Integer>(length))
+			{
+				last = static_cast<lua_Integer>(length);
+			}
+			if (first > last)
+			{
+				first = 1;
+				last = 0;
+			}
+			char const * const begin = buffer.content.begin() + (first - 1);
+			emplace_byte_buffer(*L, Si::make_memory_range(begin, begin + (last - first + 1)), buffer.owner);
+			return 1;
+		}
+
+		inline int byte_buffer_byte(lua_State *L)
+		{
+			byte_buffer &buffer = check_byte_buffer(L);
+			std::size_t const length = static_cast<std::size_t>(buffer.content.size());
+			lua_Integer first = relative_position(luaL_optinteger(L, 2, 1), length);
+			lua_Integer last = relative_position(luaL_optinteger(L, 3, first), length);
+			if (first < 1)
+			{
+				first = 1;
+			}
+			if (last > static_cast<lua_Integer>(length))
+			{
+				last = static_cast<lua_Integer>(length);
+			}
+			if (first > last)
+			{
+				return 0;
+			}
+			int const count = static_cast<int>(last - first + 1);
+			luaL_checkstack(L, count, "byte_buffer:byte has too many results");
+			for (lua_Integer i = first; i <= last; ++i)
+			{
+				lua_pushinteger(L, static_cast<unsigned char>(buffer.content.begin()[i - 1]));
+			}
+			return count;
+		}
+
+		///The meta table is created once per state and stored in the registry under type_key<byte_buffer>().
+		inline void push_byte_buffer_meta_table(lua_State &L)
+		{
+			get_or_create_meta_table(L, type_key<byte_buffer>(), [&L](stack_value &meta)
+			{
+				int const table = meta.from_bottom();
+				lua_createtable(&L, 0, 4);
+				lua_pushcfunction(&L, byte_buffer_len);
+				lua_setfield(&L, -2, "len");
+				lua_pushcfunction(&L, byte_buffer_sub);
+				lua_setfield(&L, -2, "sub");
+				lua_pushcfunction(&L, byte_buffer_byte);
+				lua_setfield(&L, -2, "byte");
+				lua_pushcfunction(&L, byte_buffer_tostring);
+				lua_setfield(&L, -2, "tostring");
+				lua_setfield(&L, table, "__index");
+				lua_pushcfunction(&L, byte_buffer_len);
+				lua_setfield(&L, table, "__len");
+				lua_pushcfunction(&L, byte_buffer_tostring);
+				lua_setfield(&L, table, "__tostring");
+				lua_pushcfunction(&L, byte_buffer_gc);
+				lua_setfield(&L, table, "__gc");
+			}).release();
+		}
+
+		inline void emplace_byte_buffer(lua_State &L, Si::memory_range content, std::shared_ptr<void const> const &owner)
+		{
+			//the new userdata is created before any C++ object because lua_newuserdata may raise an error
+			void * const storage = lua_newuserdata(&L, sizeof(byte_buffer));
+			byte_buffer * const emplaced = new (storage) byte_buffer(content, owner);
+			try
+			{
+				push_byte_buffer_meta_table(L);
+			}
+			catch (...)
+			{
+				emplaced->~byte_buffer();
+				throw;
+			}
+			lua_setmetatable(&L, -2);
+		}
+	}
+
+	inline void push(lua_State &L, byte_buffer const &buffer)
+	{
+		detail::emplace_byte_buffer(L, buffer.content, buffer.owner);
+	}
+}
+
+#endif
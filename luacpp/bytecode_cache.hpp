@@ -0,0 +1,386 @@
+#ifndef LUACPP_BYTECODE_CACHE_HPP
+#define LUACPP_BYTECODE_CACHE_HPP
+
+#include "luacpp/load.hpp"
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/cstdint.hpp>
+#include <silicium/optional.hpp>
+#include <unordered_map>
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+#include <vector>
+
+namespace lua
+{
+	namespace detail
+	{
+		struct dump_destination
+		{
+			std::vector<char> *bytes;
+			bool out_of_memory;
+		};
+
+		inline int append_dumped(lua_State *, void const *data, std::size_t size, void *destination) BOOST_NOEXCEPT
+		{
+			dump_destination &dumped = *static_cast<dump_destination *>(destination);
+			char const * const begin = static_cast<char const *>(data);
+			try
+			{
+				dumped.bytes->insert(dumped.bytes->end(), begin, begin + size);
+			}
+			catch (std::bad_alloc const &)
+			{
+				dumped.out_of_memory = true;
+				return 1;
+			}
+			return 0;
+		}
+
+		inline boost::uint64_t hash_content(Si::memory_range content) BOOST_NOEXCEPT
+		{
+			//FNV-1a
+			boost::uint64_t hash = 14695981039346656037ULL;
+			for (char c : content)
+			{
+				hash ^= static_cast<unsigned char>(c);
+				hash *= 1099511628211ULL;
+			}
+			return hash;
+		}
+
+		inline bool read_file(boost::filesystem::path const &file, std::vector<char> &content)
+		{
+			boost::filesystem::ifstream in(file, std::ios::binary);
+			if (!in)
+			{
+				return false;
+			}
+			content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+			return !in.bad();
+		}
+
+		template <class Integer>
+		void append_integer(std::vector<char> &destination, Integer value)
+		{
+			char const * const begin = reinterpret_cast<char const *>(&value);
+			destination.insert(destination.end(), begin, begin + sizeof(value));
+		}
+
+		template <class Integer>
+		bool read_integer(Si::memory_range &source, Integer &value) BOOST_NOEXCEPT
+		{
+			if (static_cast<std::size_t>(source.size()) < sizeof(value))
+			{
+				return false;
+			}
+			std::memcpy(&value, source.begin(), sizeof(value));
+			source = Si::make_memory_range(source.begin() + sizeof(value), source.end());
+			return true;
+		}
+	}
+
+	///Serializes the Lua function 'function' with lua_dump. C functions cannot be dumped.
+	SILICIUM_USE_RESULT
+	inline std::vector<char> dump(lua_State &L, any_local const &function)
+	{
+		std::vector<char> bytes;
+		detail::dump_destination destination{&bytes, false};
+		function.push(L);
+		int const rc = lua_dump(&L, detail::append_dumped, &destination);
+		lua_pop(&L, 1);
+		if (destination.out_of_memory)
+		{
+			boost::throw_exception(std::bad_alloc());
+		}
+		if (rc != 0)
+		{
+			boost::throw_exception(std::invalid_argument("lua_dump failed, probably because this is not a Lua function"));
+		}
+		return bytes;
+	}
+
+	///Stores compiled chunks in a directory. An entry is used only if the path, the modification time
+	///and the hash of the content of the script still match. The cache is not thread-safe.
+	struct file_bytecode_cache
+	{
+		explicit file_bytecode_cache(boost::filesystem::path directory, bool enabled = true)
+			: m_directory(std::move(directory))
+			, m_enabled(enabled)
+		{
+		}
+
+		boost::filesystem::path const &directory() const BOOST_NOEXCEPT
+		{
+			return m_directory;
+		}
+
+		bool is_enabled() const BOOST_NOEXCEPT
+		{
+			return m_enabled;
+		}
+
+		///A disabled cache neither reads nor writes entries and load_file behaves like the uncached version.
+		void set_enabled(bool enabled) BOOST_NOEXCEPT
+		{
+			m_enabled = enabled;
+		}
+
+		boost::filesystem::path entry_path(boost::filesystem::path const &script) const
+		{
+			std::string const key = to_utf8(boost::filesystem::absolute(script));
+			boost::uint64_t const hash = detail::hash_content(Si::make_memory_range(key));
+			char name[17];
+			for (std::size_t i = 0; i < 16; ++i)
+			{
+				name[i] = "0123456789abcdef"[(hash >> (60 - (i * 4))) & 0xf];
+			}
+			name[16] = '\0';
+			return m_directory / (std::string(name) + ".luac");
+		}
+
+		void invalidate(boost::filesystem::path const &script)
+		{
+			boost::system::error_code ignored;
+			boost::filesystem::remove(entry_path(script), ignored);
+		}
+
+		///removes all entries
+		void clear()
+		{
+			boost::system::error_code ec;
+			for (boost::filesystem::directory_iterator i(m_directory, ec), end; !ec && (i != end); i.increment(ec))
+			{
+				if (i->path().extension() == ".luac")
+				{
+					boost::system::error_code ignored;
+					boost::filesystem::remove(i->path(), ignored);
+				}
+			}
+		}
+
+	private:
+
+		boost::filesystem::path m_directory;
+		bool m_enabled;
+	};
+
+	namespace detail
+	{
+		static char const bytecode_cache_magic[8] = {'l', 'u', 'a', 'c', 'p', 'p', 'B', 'C'};
+
+		struct bytecode_cache_key
+		{
+			boost::int64_t modification_time;
+			boost::uint64_t content_size;
+			boost::uint64_t content_hash;
+			std::string absolute_path;
+		};
+
+		inline std::vector<char> serialize_cache_entry(bytecode_cache_key const &key, std::vector<char> const &bytecode)
+		{
+			std::vector<char> entry(bytecode_cache_magic, bytecode_cache_magic + sizeof(bytecode_cache_magic));
+			append_integer(entry, key.modification_time);
+			append_integer(entry, key.content_size);
+			append_integer(entry, key.content_hash);
+			append_integer(entry, static_cast<boost::uint64_t>(key.absolute_path.size()));
+			entry.insert(entry.end(), key.absolute_path.begin(), key.absolute_path.end());
+			entry.insert(entry.end(), bytecode.begin(), bytecode.end());
+			return entry;
+		}
+
+		///returns the bytecode if the entry belongs to the key
+		inline Si::optional<Si::memory_range> parse_cache_entry(bytecode_cache_key const &key, Si::memory_range entry)
+		{
+			if ((static_cast<std::size_t>(entry.size()) < sizeof(bytecode_cache_magic)) ||
+				(std::memcmp(entry.begin(), bytecode_cache_magic, sizeof(bytecode_cache_magic)) != 0))
+			{
+				return Si::none;
+			}
+			entry = Si::make_memory_range(entry.begin() + sizeof(bytecode_cache_magic), entry.end());
+			bytecode_cache_key stored;
+			boost::uint64_t path_size = 0;
+			if (!read_integer(entry, stored.modification_time) ||
+				!read_integer(entry, stored.content_size) ||
+				!read_integer(entry, stored.content_hash) ||
+				!read_integer(entry, path_size) ||
+				(static_cast<boost::uint64_t>(entry.size()) < path_size))
+			{
+				return Si::none;
+			}
+			Si::memory_range const path = Si::make_memory_range(entry.begin(), entry.begin() + path_size);
+			if ((stored.modification_time != key.modification_time) ||
+				(stored.content_size != key.content_size) ||
+				(stored.content_hash != key.content_hash) ||
+				(path_size != key.absolute_path.size()) ||
+				!std::equal(path.begin(), path.end(), key.absolute_path.begin()))
+			{
+				return Si::none;
+			}
+			return Si::make_memory_range(path.end(), entry.end());
+		}
+
+		inline void write_cache_entry(boost::filesystem::path const &entry_file, std::vector<char> const &entry)
+		{
+			boost::system::error_code ec;
+			boost::filesystem::create_directories(entry_file.parent_path(), ec);
+			boost::filesystem::path temporary = entry_file;
+			temporary += ".tmp";
+			{
+				boost::filesystem::ofstream out(temporary, std::ios::binary);
+				out.write(entry.data(), static_cast<std::streamsize>(entry.size()));
+				if (!out)
+				{
+					out.close();
+					boost::filesystem::remove(temporary, ec);
+					return;
+				}
+			}
+			//the cache is only an optimization, so failing to store an entry is not an error
+			boost::filesystem::rename(temporary, entry_file, ec);
+		}
+	}
+
+	///Like load_file, but reuses the bytecode of an earlier compilation when the script has not changed since.
+	SILICIUM_USE_RESULT
+	inline result load_file(lua_State &stack, boost::filesystem::path const &file, file_bytecode_cache &cache)
+	{
+		if (!cache.is_enabled())
+		{
+			return load_file(stack, file);
+		}
+		std::vector<char> source;
+		boost::system::error_code ec;
+		std::time_t const modification_time = boost::filesystem::last_write_time(file, ec);
+		if (ec || !detail::read_file(file, source))
+		{
+			//produces the usual error message
+			return load_file(stack, file);
+		}
+		Si::memory_range const source_range = Si::make_memory_range(source);
+		detail::bytecode_cache_key const key
+		{
+			static_cast<boost::int64_t>(modification_time),
+			source.size(),
+			detail::hash_content(source_range),
+			to_utf8(boost::filesystem::absolute(file))
+		};
+		std::string const chunk_name = detail::file_chunk_name(file);
+		boost::filesystem::path const entry_file = cache.entry_path(file);
+		{
+			std::vector<char> entry;
+			if (detail::read_file(entry_file, entry))
+			{
+				Si::optional<Si::memory_range> const bytecode = detail::parse_cache_entry(key, Si::make_memory_range(entry));
+				if (bytecode)
+				{
+					result loaded = load_buffer(stack, *bytecode, chunk_name.c_str());
+					if (!loaded.is_error())
+					{
+						return loaded;
+					}
+				}
+			}
+		}
+		result compiled = load_buffer(stack, detail::skip_shebang_line(source_range), chunk_name.c_str());
+		if (!compiled.is_error())
+		{
+			detail::write_cache_entry(entry_file, detail::serialize_cache_entry(key, dump(stack, compiled.value())));
+		}
+		return compiled;
+	}
+
+	///Keeps compiled chunks in memory so that the same code can be loaded into many states without being parsed again.
+	///Entries are identified by the chunk name and are only used if the code is exactly the same.
+	///The cache is not thread-safe.
+	struct memory_bytecode_cache
+	{
+		memory_bytecode_cache() BOOST_NOEXCEPT
+			: m_enabled(true)
+		{
+		}
+
+		bool is_enabled() const BOOST_NOEXCEPT
+		{
+			return m_enabled;
+		}
+
+		void set_enabled(bool enabled) BOOST_NOEXCEPT
+		{
+			m_enabled = enabled;
+		}
+
+		std::size_t size() const BOOST_NOEXCEPT
+		{
+			return m_entries.size();
+		}
+
+		void invalidate(char const *name)
+		{
+			m_entries.erase(name);
+		}
+
+		void clear() BOOST_NOEXCEPT
+		{
+			m_entries.clear();
+		}
+
+		Si::optional<Si::memory_range> find(Si::memory_range code, char const *name) const
+		{
+			auto const found = m_entries.find(name);
+			if ((found == m_entries.end()) ||
+				(found->second.source.size() != static_cast<std::size_t>(code.size())) ||
+				!std::equal(code.begin(), code.end(), found->second.source.begin()))
+			{
+				return Si::none;
+			}
+			return Si::make_memory_range(found->second.bytecode);
+		}
+
+		void store(Si::memory_range code, char const *name, std::vector<char> bytecode)
+		{
+			entry &stored = m_entries[name];
+			stored.source.assign(code.begin(), code.end());
+			stored.bytecode = std::move(bytecode);
+		}
+
+	private:
+
+		struct entry
+		{
+			std::vector<char> source;
+			std::vector<char> bytecode;
+		};
+
+		std::unordered_map<std::string, entry> m_entries;
+		bool m_enabled;
+	};
+
+	///Like load_buffer, but compiles a given piece of code only once per cache.
+	SILICIUM_USE_RESULT
+	inline result load_buffer(lua_State &stack, Si::memory_range code, char const *name, memory_bytecode_cache &cache)
+	{
+		if (!cache.is_enabled())
+		{
+			return load_buffer(stack, code, name);
+		}
+		Si::optional<Si::memory_range> const bytecode = cache.find(code, name);
+		if (bytecode)
+		{
+			result loaded = load_buffer(stack, *bytecode, name);
+			if (!loaded.is_error())
+			{
+				return loaded;
+			}
+		}
+		result compiled = load_buffer(stack, code, name);
+		if (!compiled.is_error())
+		{
+			cache.store(code, name, dump(stack, compiled.value()));
+		}
+		return compiled;
+	}
+}
+
+#endif
@@ -0,0 +1,379 @@
+#ifndef LUACPP_CLASS_BUILDER_HPP
+#define LUACPP_CLASS_BUILDER_HPP
+
+#include "luacpp/meta_table.hpp"
+#include "luacpp/register_closure.hpp"
+#include <boost/throw_exception.hpp>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace lua
+{
+	namespace detail
+	{
+		///Maps a fixed set of pointers to distinct slots with a multiplication and a shift.
+		struct perfect_hash
+		{
+			std::size_t multiplier;
+			unsigned shift;
+			std::size_t size;
+
+			std::size_t operator()(void const *key) const BOOST_NOEXCEPT
+			{
+				return (static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(key)) * multiplier) >> shift;
+			}
+		};
+
+		///Tries odd multipliers for growing power-of-two table sizes until no two keys share a slot.
+		///The keys have to be distinct.
+		inline perfect_hash find_perfect_hash(std::vector<void const *> const &keys)
+		{
+			unsigned const bits = static_cast<unsigned>(std::numeric_limits<std::size_t>::digits);
+			unsigned size_bits = 1;
+			while ((std::size_t(1) << size_bits) < keys.size())
+			{
+				++size_bits;
+			}
+			std::vector<bool> occupied;
+			std::size_t multiplier = static_cast<std::size_t>(0x9e3779b97f4a7c15ULL);
+			for (unsigned const last_size_bits = size_bits + 4; size_bits <= last_size_bits; ++size_bits)
+			{
+				for (int attempt = 0; attempt < 64; ++attempt)
+				{
+					perfect_hash const candidate{multiplier | 1, bits - size_bits, std::size_t(1) << size_bits};
+					occupied.assign(candidate.size, false);
+					bool collision = false;
+					for (void const *key : keys)
+					{
+						std::size_t const slot = candidate(key);
+						if (occupied[slot])
+						{
+							collision = true;
+							break;
+						}
+						occupied[slot] = true;
+					}
+					if (!collision)
+					{
+						return candidate;
+					}
+					//next value of an LCG, only the odd multipliers are used
+					multiplier = multiplier * static_cast<std::size_t>(6364136223846793005ULL) + static_cast<std::size_t>(1442695040888963407ULL);
+				}
+			}
+			boost::throw_exception(std::logic_error("Could not find a perfect hash for the members of a class"));
+		}
+
+		template <class T>
+		struct property_accessor
+		{
+			virtual ~property_accessor()
+			{
+			}
+
+			virtual bool is_writable() const BOOST_NOEXCEPT = 0;
+			virtual void get(lua_State &L, T const &object) const = 0;
+			virtual void set(lua_State &L, T &object, int value) const = 0;
+		};
+
+		template <class T, class Field>
+		struct field_accessor : property_accessor<T>
+		{
+			field_accessor(Field T::*field, bool writable) BOOST_NOEXCEPT
+				: m_field(field)
+				, m_writable(writable)
+			{
+			}
+
+			virtual bool is_writable() const BOOST_NOEXCEPT SILICIUM_OVERRIDE
+			{
+				return m_writable;
+			}
+
+			virtual void get(lua_State &L, T const &object) const SILICIUM_OVERRIDE
+			{
+				push(L, object.*m_field);
+			}
+
+			virtual void set(lua_State &L, T &object, int value) const SILICIUM_OVERRIDE
+			{
+				assert(m_writable);
+				object.*m_field = from_lua_cast<Field>(L, value);
+			}
+
+		private:
+
+			Field T::*m_field;
+			bool m_writable;
+		};
+
+		template <class T>
+		struct class_member
+		{
+			std::string name;
+
+			///empty for properties
+			std::function<stack_value (stack &)> register_method;
+
+			///empty for methods
+			std::shared_ptr<property_accessor<T> const> property;
+		};
+
+		///A message in plain memory, so that it survives the exception it was copied from. lua_error does not return,
+		///so it can only be called after every C++ object with a destructor is gone.
+		struct access_error
+		{
+			char text[256];
+
+			void assign(char const *message) BOOST_NOEXCEPT
+			{
+				std::strncpy(text, message, sizeof(text) - 1);
+				text[sizeof(text) - 1] = '\0';
+			}
+		};
+
+		///Runs a property accessor and copies the message of an exception it throws into 'error'.
+		template <class Access>
+		bool try_access(Access &&access, access_error &error) BOOST_NOEXCEPT
+		{
+			try
+			{
+				std::forward<Access>(access)();
+				return true;
+			}
+			catch (std::exception const &ex)
+			{
+				error.assign(ex.what());
+			}
+			catch (...)
+			{
+				error.assign("A property accessor threw an unknown exception");
+			}
+			return false;
+		}
+
+		inline int raise_access_error(lua_State *L, access_error const &error) BOOST_NOEXCEPT
+		{
+			lua_pushstring(L, error.text);
+			return lua_error(L);
+		}
+
+		///The state of the generated __index and __newindex functions. It is stored in a user data upvalue.
+		template <class T>
+		struct class_dispatch
+		{
+			struct slot
+			{
+				///the characters of the interned Lua string, nullptr for an unused slot
+				void const *key;
+
+				///index into the methods upvalue, 0 for properties
+				int method;
+
+				property_accessor<T> const *property;
+			};
+
+			perfect_hash hash;
+			std::vector<slot> slots;
+			std::vector<std::shared_ptr<property_accessor<T> const>> properties;
+
+			///returns nullptr if the key is not a string or not a member
+			slot const *find(lua_State &L, int key) const BOOST_NOEXCEPT
+			{
+				if (::lua_type(&L, key) != LUA_TSTRING)
+				{
+					return nullptr;
+				}
+				//Lua interns all strings, so equal names have equal character pointers
+				void const * const characters = lua_tostring(&L, key);
+				slot const &candidate = slots[hash(characters)];
+				return (candidate.key == characters) ? &candidate : nullptr;
+			}
+
+			static int index(lua_State *L) BOOST_NOEXCEPT
+			{
+				class_dispatch const &dispatch = *static_cast<class_dispatch const *>(lua_touserdata(L, lua_upvalueindex(1)));
+				slot const * const found = dispatch.find(*L, 2);
+				if (!found)
+				{
+					lua_pushnil(L);
+				}
+				else if (found->method)
+				{
+					lua_rawgeti(L, lua_upvalueindex(3), found->method);
+				}
+				else
+				{
+					T const * const object = to_object<T>(*L, 1);
+					if (!object)
+					{
+						lua_pushliteral(L, "Cannot read a property of a value that is not an object of this class");
+						return lua_error(L);
+					}
+					access_error error;
+					if (!try_access([L, found, object]() { found->property->get(*L, *object); }, error))
+					{
+						return raise_access_error(L, error);
+					}
+				}
+				return 1;
+			}
+
+			static int new_index(lua_State *L) BOOST_NOEXCEPT
+			{
+				class_dispatch const &dispatch = *static_cast<class_dispatch const *>(lua_touserdata(L, lua_upvalueindex(1)));
+				slot const * const found = dispatch.find(*L, 2);
+				if (!found || !found->property || !found->property->is_writable())
+				{
+					//only pointers are alive here, so leaving with a Lua error is fine
+					lua_pushliteral(L, "Cannot assign to a member that is not a writable property: ");
+					lua_pushvalue(L, 2);
+					lua_concat(L, 2);
+					return lua_error(L);
+				}
+				T * const object = to_object<T>(*L, 1);
+				if (!object)
+				{
+					lua_pushliteral(L, "Cannot write a property of a value that is not an object of this class");
+					return lua_error(L);
+				}
+				access_error error;
+				if (!try_access([L, found, object]() { found->property->set(*L, *object, 3); }, error))
+				{
+					return raise_access_error(L, error);
+				}
+				return 0;
+			}
+		};
+	}
+
+	///Declares the methods and properties of a C++ type for Lua. apply replaces __index and __newindex of a meta table
+	///with C functions that find a member with a single multiplication and a pointer comparison, because Lua interns
+	///the names. Properties are read and written directly without calling a Lua function.
+	///A builder describes the class and can be applied to the meta tables of many states.
+	template <class T>
+	struct class_builder
+	{
+		///method can be a pointer to a member function or a functor that takes T & or T * first, like in add_method.
+		template <class Method>
+		class_builder &method(std::string name, Method method)
+		{
+			detail::class_member<T> &added = member(std::move(name));
+			added.register_method = [method](stack &s)
+			{
+				return detail::register_method(s, method);
+			};
+			added.property.reset();
+			return *this;
+		}
+
+		template <class Field>
+		class_builder &property(std::string name, Field T::*field)
+		{
+			detail::class_member<T> &added = member(std::move(name));
+			added.register_method = nullptr;
+			added.property = std::make_shared<detail::field_accessor<T, Field>>(field, true);
+			return *this;
+		}
+
+		template <class Field>
+		class_builder &read_only(std::string name, Field T::*field)
+		{
+			detail::class_member<T> &added = member(std::move(name));
+			added.register_method = nullptr;
+			added.property = std::make_shared<detail::field_accessor<T, Field>>(field, false);
+			return *this;
+		}
+
+		///The meta table is supposed to belong to user data created with emplace_object<T>, for example the one from
+		///create_default_meta_table<T>.
+		void apply(stack &s, stack_value &meta) const
+		{
+			typedef detail::class_dispatch<T> dispatch_type;
+			lua_State &L = *s.state();
+			stack_value data = create_user_data(L, sizeof(dispatch_type));
+			dispatch_type * const dispatch = static_cast<dispatch_type *>(to_user_data(data));
+			assert(dispatch);
+			new (dispatch) dispatch_type();
+			{
+				std::unique_ptr<dispatch_type, detail::placement_destructor> dispatch_handle(dispatch);
+				detail::set_closure_meta_table<dispatch_type>(s, data, boost::mpl::bool_<false>());
+				dispatch_handle.release();
+			}
+
+			//the names table keeps the interned strings alive, so their addresses stay valid
+			stack_value names = create_table(L, static_cast<int>(m_members.size()), 0);
+			stack_value methods = create_table(L);
+			std::vector<void const *> keys;
+			keys.reserve(m_members.size());
+			int method_count = 0;
+			for (std::size_t i = 0; i < m_members.size(); ++i)
+			{
+				detail::class_member<T> const &declared = m_members[i];
+				lua_pushlstring(&L, declared.name.data(), declared.name.size());
+				keys.push_back(lua_tostring(&L, -1));
+				lua_rawseti(&L, names.from_bottom(), static_cast<int>(i + 1));
+				if (declared.register_method)
+				{
+					++method_count;
+					set_element(methods, static_cast<lua_Integer>(method_count), declared.register_method(s));
+				}
+			}
+
+			dispatch->hash = detail::find_perfect_hash(keys);
+			typename dispatch_type::slot const unused = {nullptr, 0, nullptr};
+			dispatch->slots.assign(dispatch->hash.size, unused);
+			method_count = 0;
+			for (std::size_t i = 0; i < m_members.size(); ++i)
+			{
+				detail::class_member<T> const &declared = m_members[i];
+				typename dispatch_type::slot &assigned = dispatch->slots[dispatch->hash(keys[i])];
+				assigned.key = keys[i];
+				if (declared.register_method)
+				{
+					assigned.method = ++method_count;
+				}
+				else
+				{
+					dispatch->properties.push_back(declared.property);
+					assigned.property = declared.property.get();
+				}
+			}
+
+			lua_pushvalue(&L, data.from_bottom());
+			lua_pushvalue(&L, names.from_bottom());
+			lua_pushvalue(&L, methods.from_bottom());
+			set_element(meta, "__index", register_function_with_existing_upvalues(L, dispatch_type::index, 3));
+			lua_pushvalue(&L, data.from_bottom());
+			lua_pushvalue(&L, names.from_bottom());
+			set_element(meta, "__newindex", register_function_with_existing_upvalues(L, dispatch_type::new_index, 2));
+		}
+
+	private:
+
+		std::vector<detail::class_member<T>> m_members;
+
+		///a member declared again replaces the earlier declaration
+		detail::class_member<T> &member(std::string name)
+		{
+			for (detail::class_member<T> &existing : m_members)
+			{
+				if (existing.name == name)
+				{
+					return existing;
+				}
+			}
+			m_members.emplace_back();
+			m_members.back().name = std::move(name);
+			return m_members.back();
+		}
+	};
+}
+
+#endif
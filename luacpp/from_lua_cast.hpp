@@ -4,7 +4,15 @@
 #include "luacpp/stack_value.hpp"
 #include "luacpp/stack.hpp"
 #include "luacpp/reference.hpp"
+#include "luacpp/byte_buffer.hpp"
 #include <silicium/memory_range.hpp>
+#include <silicium/detail/integer_sequence.hpp>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 namespace lua
 {
@@ -82,6 +90,7 @@ namespace lua
 		}
 	};
 
+	///Accepts strings and byte buffers. The range stays valid while the value is on the stack.
 	template <>
 	struct from_lua<Si::memory_range>
 	{
@@ -89,6 +98,10 @@ namespace lua
 
 		Si::memory_range operator()(lua_State &L, int address) const
 		{
+			if (byte_buffer const * const buffer = detail::to_byte_buffer(L, address))
+			{
+				return buffer->content;
+			}
 			std::size_t length = 0;
 			char const *begin = lua_tolstring(&L, address, &length);
 			return Si::make_memory_range(begin, begin + length);
@@ -104,6 +117,97 @@ namespace lua
 		}
 	};
 	
+	namespace detail
+	{
+		inline int absolute_index(lua_State &L, int address) BOOST_NOEXCEPT
+		{
+			if ((address < 0) && (address > LUA_REGISTRYINDEX))
+			{
+				return lua_gettop(&L) + address + 1;
+			}
+			return address;
+		}
+
+		///Reads the elements 1 to 'count' of the table with raw accesses. Metamethods are not used.
+		template <class T, class OutputIterator>
+		void read_array(lua_State &L, int table, std::size_t count, OutputIterator destination)
+		{
+			for (std::size_t i = 1; i <= count; ++i, ++destination)
+			{
+				lua_rawgeti(&L, table, static_cast<int>(i));
+				*destination = from_lua<T>()(L, -1);
+				lua_pop(&L, 1);
+			}
+		}
+	}
+
+	///Converts the array part of a table (as far as the # operator sees it). Anything else results in an empty vector.
+	template <class T, class Allocator>
+	struct from_lua<std::vector<T, Allocator>>
+	{
+		static type const lua_type = type::table;
+
+		std::vector<T, Allocator> operator()(lua_State &L, int address) const
+		{
+			int const table = detail::absolute_index(L, address);
+			std::vector<T, Allocator> elements;
+			//lua_istable would find the member lua_type
+			if (::lua_type(&L, table) != LUA_TTABLE)
+			{
+				return elements;
+			}
+			std::size_t const size = lua_objlen(&L, table);
+			elements.reserve(size);
+			detail::read_array<T>(L, table, size, std::back_inserter(elements));
+			return elements;
+		}
+	};
+
+	///Elements missing in the table are value-initialized. Additional elements are ignored.
+	template <class T, std::size_t N>
+	struct from_lua<std::array<T, N>>
+	{
+		static type const lua_type = type::table;
+
+		std::array<T, N> operator()(lua_State &L, int address) const
+		{
+			int const table = detail::absolute_index(L, address);
+			std::array<T, N> elements = {};
+			//lua_istable would find the member lua_type
+			if (::lua_type(&L, table) != LUA_TTABLE)
+			{
+				return elements;
+			}
+			detail::read_array<T>(L, table, (std::min)(N, lua_objlen(&L, table)), elements.begin());
+			return elements;
+		}
+	};
+
+	namespace detail
+	{
+		///the index of the first alternative whose lua_type is LuaType, or the last index if there is none
+		template <int LuaType, std::size_t Index, class ...T>
+		struct first_alternative_of_type;
+
+		template <int LuaType, std::size_t Index, class Last>
+		struct first_alternative_of_type<LuaType, Index, Last> : std::integral_constant<std::size_t, Index>
+		{
+		};
+
+		template <int LuaType, std::size_t Index, class First, class Second, class ...Rest>
+		struct first_alternative_of_type<LuaType, Index, First, Second, Rest...>
+			: std::conditional<
+				static_cast<int>(from_lua<First>::lua_type) == LuaType,
+				std::integral_constant<std::size_t, Index>,
+				first_alternative_of_type<LuaType, Index + 1, Second, Rest...>
+			>::type
+		{
+		};
+	}
+
+	///Dispatches on the Lua type through a table that is computed at compile time, so exactly one alternative is
+	///converted. If several alternatives have the same lua_type (lua_Integer and lua_Number for example), the first
+	///one in the declaration order is used. A value of a type without a matching alternative is converted to the last one.
 	template <class ...T>
 	struct from_lua<Si::fast_variant<T...>>
 	{
@@ -111,30 +215,32 @@ namespace lua
 
 		variant operator()(lua_State &L, int address) const
 		{
-			static std::array<std::pair<variant, bool> (*)(any_local), sizeof...(T)> const converters =
-			{{
-				&try_convert<T>...
-			}};
-			std::pair<variant, bool> result = converters[0](any_local(L, address));
-			for (auto const &converter : converters)
-			{
-				if (result.second)
-				{
-					break;
-				}
-				result = converter(any_local(L, address));
-			}
-			return std::move(result.first);
+			typedef variant (*converter)(lua_State &, int);
+			//indexed by the result of lua_type + 1 which covers LUA_TNONE to LUA_TTHREAD
+			static std::array<converter, 10> const converters = make_converters(typename ranges::v3::make_integer_sequence<10>::type());
+			int const type_index = ::lua_type(&L, address) + 1;
+			assert(type_index >= 0);
+			assert(static_cast<std::size_t>(type_index) < converters.size());
+			return converters[static_cast<std::size_t>(type_index)](L, address);
 		}
 
 	private:
 
-		template <class To>
-		static std::pair<variant, bool> try_convert(any_local from)
+		template <std::size_t Index>
+		static variant convert(lua_State &L, int address)
 		{
-			auto const type = get_type(from);
-			bool is_correct_type = (from_lua<To>::lua_type == type);
-			return std::make_pair(variant(from_lua<To>()(*from.thread(), from.from_bottom())), is_correct_type);
+			typedef typename std::tuple_element<Index, std::tuple<T...>>::type alternative;
+			return variant(from_lua<alternative>()(L, address));
+		}
+
+		template <std::size_t ...TypeIndices>
+		static std::array<variant (*)(lua_State &, int), 10> make_converters(ranges::v3::integer_sequence<TypeIndices...>)
+		{
+			std::array<variant (*)(lua_State &, int), 10> const converters =
+			{{
+				&convert<detail::first_alternative_of_type<static_cast<int>(TypeIndices) - 1, 0, T...>::value>...
+			}};
+			return converters;
 		}
 	};
 
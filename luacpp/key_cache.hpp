@@ -0,0 +1,150 @@
+#ifndef LUACPP_KEY_CACHE_HPP
+#define LUACPP_KEY_CACHE_HPP
+
+#include "luacpp/reference.hpp"
+#include "luacpp/type_registry.hpp"
+#include <boost/noncopyable.hpp>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace lua
+{
+	///A string that lives in the registry. Pushing it is a lua_rawgeti, so the characters are not hashed again.
+	struct interned_key
+	{
+		int registry_key;
+
+		interned_key() BOOST_NOEXCEPT
+			: registry_key(LUA_NOREF)
+		{
+		}
+
+		explicit interned_key(int registry_key) BOOST_NOEXCEPT
+			: registry_key(registry_key)
+		{
+		}
+
+		bool empty() const BOOST_NOEXCEPT
+		{
+			return registry_key == LUA_NOREF;
+		}
+	};
+
+	inline void push(lua_State &L, interned_key key) BOOST_NOEXCEPT
+	{
+		assert(!key.empty());
+		lua_rawgeti(&L, LUA_REGISTRYINDEX, key.registry_key);
+	}
+
+	///Interns a fixed set of field names once per state. The keys can be used wherever a key is pushed, for example
+	///with set_element, get_element and stack_value::operator[].
+	///All caches of a state share one registry slot per name. The slots are found through a table in the registry,
+	///so a name is referenced only once no matter how many caches intern it. Therefore the cache does not release
+	///anything when it is destroyed and does not touch the state. It can even be owned by a user data and die during
+	///lua_close.
+	struct key_cache : private boost::noncopyable
+	{
+		key_cache() BOOST_NOEXCEPT
+		{
+		}
+
+		key_cache(main_thread thread, std::initializer_list<char const *> names)
+			: m_thread(thread)
+		{
+			m_entries.reserve(names.size());
+			for (char const *name : names)
+			{
+				intern(name);
+			}
+		}
+
+		std::size_t size() const BOOST_NOEXCEPT
+		{
+			return m_entries.size();
+		}
+
+		///the key for the index-th name given to the constructor or to intern
+		interned_key operator[](std::size_t index) const BOOST_NOEXCEPT
+		{
+			assert(index < m_entries.size());
+			return m_entries[index].key;
+		}
+
+		///Looks the name up by comparing the characters. Use the index operator on hot paths.
+		interned_key find(char const *name) const BOOST_NOEXCEPT
+		{
+			for (entry const &interned : m_entries)
+			{
+				if (interned.name == name)
+				{
+					return interned.key;
+				}
+			}
+			return interned_key();
+		}
+
+		interned_key intern(char const *name)
+		{
+			interned_key const existing = find(name);
+			if (!existing.empty())
+			{
+				return existing;
+			}
+			lua_State * const L = m_thread.get();
+			assert(L);
+			m_entries.reserve(m_entries.size() + 1);
+			std::string copied_name = name;
+			lua_pushstring(L, name);
+			interned_key const key(find_or_create_slot(*L));
+			m_entries.push_back(entry{std::move(copied_name), key});
+			return key;
+		}
+
+	private:
+
+		struct entry
+		{
+			std::string name;
+			interned_key key;
+		};
+
+		main_thread m_thread;
+		std::vector<entry> m_entries;
+
+		///pops the name and returns the registry slot that holds it
+		static int find_or_create_slot(lua_State &L)
+		{
+			int const name = lua_gettop(&L);
+			push_registered(L, type_key<key_cache>());
+			if (::lua_type(&L, -1) != LUA_TTABLE)
+			{
+				lua_pop(&L, 1);
+				lua_newtable(&L);
+				lua_pushlightuserdata(&L, type_key<key_cache>());
+				lua_pushvalue(&L, -2);
+				lua_rawset(&L, LUA_REGISTRYINDEX);
+			}
+			int const slots = lua_gettop(&L);
+			lua_pushvalue(&L, name);
+			lua_rawget(&L, slots);
+			int registry_key = LUA_NOREF;
+			if (lua_isnumber(&L, -1))
+			{
+				registry_key = static_cast<int>(lua_tointeger(&L, -1));
+			}
+			else
+			{
+				lua_pushvalue(&L, name);
+				registry_key = luaL_ref(&L, LUA_REGISTRYINDEX);
+				lua_pushvalue(&L, name);
+				lua_pushinteger(&L, registry_key);
+				lua_rawset(&L, slots);
+			}
+			lua_settop(&L, name - 1);
+			return registry_key;
+		}
+	};
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include "luacpp/exception.hpp"
 #include "luacpp/path.hpp"
 #include <silicium/config.hpp>
+#include <algorithm>
 
 namespace lua
 {
@@ -103,6 +104,25 @@ namespace lua
 		SILICIUM_DELETED_FUNCTION(result &operator = (result const &))
 	};
 
+	namespace detail
+	{
+		///luaL_loadfile ignores the first line if it starts with #. The line break is kept so that line numbers do not change.
+		inline Si::memory_range skip_shebang_line(Si::memory_range code) BOOST_NOEXCEPT
+		{
+			if (code.empty() || (*code.begin() != '#'))
+			{
+				return code;
+			}
+			char const *line_end = std::find(code.begin(), code.end(), '\n');
+			return Si::make_memory_range(line_end, code.end());
+		}
+
+		inline std::string file_chunk_name(boost::filesystem::path const &file)
+		{
+			return "@" + to_utf8(file);
+		}
+	}
+
 	SILICIUM_USE_RESULT
 	inline result load_buffer(lua_State &stack, Si::memory_range code, char const *name)
 	{
@@ -0,0 +1,45 @@
+#ifndef LUACPP_LOAD_MAPPED_FILE_HPP
+#define LUACPP_LOAD_MAPPED_FILE_HPP
+
+#include "luacpp/load.hpp"
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace lua
+{
+	///Like load_file, but maps the source or bytecode file into memory and hands it to lua_load as a single
+	///block instead of reading it through stdio.
+	SILICIUM_USE_RESULT
+	inline result load_mapped_file(lua_State &stack, boost::filesystem::path const &file)
+	{
+		std::string const chunk_name = detail::file_chunk_name(file);
+		boost::system::error_code ec;
+		boost::uintmax_t const file_size = boost::filesystem::file_size(file, ec);
+		if (ec)
+		{
+			lua_pushfstring(&stack, "cannot open %s: %s", to_utf8(file).c_str(), ec.message().c_str());
+			stack_value error(stack, lua_gettop(&stack));
+			return result(LUA_ERRFILE, std::move(error));
+		}
+		if (file_size == 0)
+		{
+			//an empty file cannot be mapped
+			return load_buffer(stack, Si::memory_range(), chunk_name.c_str());
+		}
+		boost::iostreams::mapped_file_source mapped;
+		try
+		{
+			mapped.open(file);
+		}
+		catch (std::ios_base::failure const &ex)
+		{
+			lua_pushfstring(&stack, "cannot open %s: %s", to_utf8(file).c_str(), ex.what());
+			stack_value error(stack, lua_gettop(&stack));
+			return result(LUA_ERRFILE, std::move(error));
+		}
+		Si::memory_range const content = Si::make_memory_range(mapped.data(), mapped.data() + mapped.size());
+		return load_buffer(stack, detail::skip_shebang_line(content), chunk_name.c_str());
+	}
+}
+
+#endif
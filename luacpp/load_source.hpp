@@ -0,0 +1,177 @@
+#ifndef LUACPP_LOAD_SOURCE_HPP
+#define LUACPP_LOAD_SOURCE_HPP
+
+#include "luacpp/load.hpp"
+#include <silicium/source/source.hpp>
+#include <algorithm>
+#include <array>
+#include <exception>
+
+namespace lua
+{
+	namespace detail
+	{
+		///Does what skip_shebang_line does for a chunk that arrives in blocks. The first line can span many blocks.
+		struct shebang_filter
+		{
+			enum position
+			{
+				at_start,
+				in_first_line,
+				after_first_line
+			};
+
+			position state;
+
+			shebang_filter() BOOST_NOEXCEPT
+				: state(at_start)
+			{
+			}
+
+			///returns the part of the block that Lua should see, which is empty if the whole block is skipped
+			Si::memory_range filter(Si::memory_range block) BOOST_NOEXCEPT
+			{
+				if ((state == after_first_line) || block.empty())
+				{
+					return block;
+				}
+				if (state == at_start)
+				{
+					if (*block.begin() != '#')
+					{
+						state = after_first_line;
+						return block;
+					}
+					state = in_first_line;
+				}
+				char const * const line_end = std::find(block.begin(), block.end(), '\n');
+				if (line_end != block.end())
+				{
+					state = after_first_line;
+				}
+				return Si::make_memory_range(line_end, block.end());
+			}
+		};
+
+		template <class Source>
+		struct char_source_reader
+		{
+			Source *from;
+			std::exception_ptr exception;
+			std::array<char, 4096> buffer;
+			shebang_filter shebang;
+
+			static char const *read(lua_State *, void *data, std::size_t *size) BOOST_NOEXCEPT
+			{
+				char_source_reader &reader = *static_cast<char_source_reader *>(data);
+				try
+				{
+					for (;;)
+					{
+						char * const copied_end = reader.from->copy_next(Si::make_iterator_range(reader.buffer.data(), reader.buffer.data() + reader.buffer.size()));
+						if (copied_end == reader.buffer.data())
+						{
+							*size = 0;
+							return nullptr;
+						}
+						Si::memory_range const visible = reader.shebang.filter(Si::make_memory_range(reader.buffer.data(), copied_end));
+						//an empty block would tell Lua that the chunk has ended
+						if (visible.empty())
+						{
+							continue;
+						}
+						*size = static_cast<std::size_t>(visible.size());
+						return visible.begin();
+					}
+				}
+				catch (...)
+				{
+					reader.exception = std::current_exception();
+					*size = 0;
+					return nullptr;
+				}
+			}
+		};
+
+		template <class Source>
+		struct range_source_reader
+		{
+			Source *from;
+			std::exception_ptr exception;
+			shebang_filter shebang;
+
+			static char const *read(lua_State *, void *data, std::size_t *size) BOOST_NOEXCEPT
+			{
+				range_source_reader &reader = *static_cast<range_source_reader *>(data);
+				try
+				{
+					for (;;)
+					{
+						auto const chunk = Si::get(*reader.from);
+						if (!chunk)
+						{
+							*size = 0;
+							return nullptr;
+						}
+						Si::memory_range const visible = reader.shebang.filter(*chunk);
+						//an empty block would tell Lua that the chunk has ended
+						if (visible.empty())
+						{
+							continue;
+						}
+						*size = static_cast<std::size_t>(visible.size());
+						return visible.begin();
+					}
+				}
+				catch (...)
+				{
+					reader.exception = std::current_exception();
+					*size = 0;
+					return nullptr;
+				}
+			}
+		};
+
+		template <class Reader>
+		result load_with_reader(lua_State &stack, Reader &reader, char const *name)
+		{
+			int const rc = lua_load(&stack, &Reader::read, &reader, name);
+			stack_value value(stack, lua_gettop(&stack));
+			if (reader.exception)
+			{
+				value.pop();
+				std::rethrow_exception(reader.exception);
+			}
+			return result(rc, std::move(value));
+		}
+
+		template <class Source>
+		result load_source(lua_State &stack, Source &source, char const *name, char)
+		{
+			char_source_reader<Source> reader{&source, nullptr, {}, shebang_filter()};
+			return load_with_reader(stack, reader, name);
+		}
+
+		template <class Source>
+		result load_source(lua_State &stack, Source &source, char const *name, Si::memory_range)
+		{
+			range_source_reader<Source> reader{&source, nullptr, shebang_filter()};
+			return load_with_reader(stack, reader, name);
+		}
+	}
+
+	///Compiles a chunk while it is being read from a source of char or of Si::memory_range.
+	///A memory_range has to stay valid until the next element is requested from the source.
+	///Exceptions thrown by the source are rethrown after Lua has given up on the chunk.
+	///Like luaL_loadfile, a first line starting with # is ignored.
+	template <class Source>
+	SILICIUM_USE_RESULT
+	result load_source(lua_State &stack, Source &&source, char const *name)
+	{
+		typedef typename std::decay<Source>::type clean_source;
+		typedef typename clean_source::element_type element_type;
+		return detail::load_source(stack, source, name, element_type());
+	}
+}
+
+#endif
@@ -4,7 +4,9 @@
 #include "luacpp/register_any_function.hpp"
 #include "luacpp/stack.hpp"
 #include "luacpp/stack_value.hpp"
+#include "luacpp/type_registry.hpp"
 #include <boost/mpl/or.hpp>
+#include <type_traits>
 
 namespace lua
 {
@@ -46,24 +48,72 @@ namespace lua
 		return obj;
 	}
 
-	template <class T>
-	lua::stack_value create_default_meta_table(lua::stack &s)
+	namespace detail
 	{
-		lua::stack_value meta = create_table(*s.state());
-		set_element(meta, "__index", meta);
-		set_element(meta, "__metatable", "USERDATA");
-		set_element(meta, "__gc", lua::register_function(*s.state(), [](lua_State *L) -> int
+		template <class T>
+		void set_destructor(lua::stack &, stack_value &, boost::mpl::bool_<true>)
 		{
-			T *obj = static_cast<T *>(lua_touserdata(L, -1));
+			//Without __gc the collector frees the user data in a single sweep instead of finalizing it first.
+		}
+
+		template <class T>
+		void set_destructor(lua::stack &s, stack_value &meta, boost::mpl::bool_<false>)
+		{
+			set_element(meta, "__gc", lua::register_function(*s.state(), [](lua_State *L) -> int
+			{
+				T *obj = static_cast<T *>(lua_touserdata(L, -1));
 #ifdef _MSC_VER
-			//workaround for VC++ 2013 bug
-			boost::ignore_unused_variable_warning(obj);
+				//workaround for VC++ 2013 bug
+				boost::ignore_unused_variable_warning(obj);
 #endif
-			assert(obj);
-			obj->~T();
-			return 0;
-		}));
-		return meta;
+				assert(obj);
+				obj->~T();
+				return 0;
+			}));
+		}
+
+		template <class T>
+		void fill_default_meta_table(lua::stack &s, stack_value &meta)
+		{
+			set_element(meta, "__index", meta);
+			set_element(meta, "__metatable", "USERDATA");
+			set_destructor<T>(s, meta, boost::mpl::bool_<std::is_trivially_destructible<T>::value>());
+		}
+	}
+
+	///The meta table for T is created once per state and kept in the registry under type_key<T>().
+	///initialize is called with the new table only when it is created, so this is the place to add methods.
+	template <class T, class Initializer>
+	lua::stack_value create_default_meta_table(lua::stack &s, Initializer &&initialize)
+	{
+		return get_or_create_meta_table(*s.state(), type_key<T>(), [&s, &initialize](stack_value &meta)
+		{
+			detail::fill_default_meta_table<T>(s, meta);
+			std::forward<Initializer>(initialize)(meta);
+		});
+	}
+
+	///Returns the shared meta table for T. Methods added to it are visible to all objects of T in this state.
+	template <class T>
+	lua::stack_value create_default_meta_table(lua::stack &s)
+	{
+		return create_default_meta_table<T>(s, [](stack_value &)
+		{
+		});
+	}
+
+	///Pushes the meta table registered for T, creating the default one if there is none yet. This avoids a
+	///stack_value for the table when passing it to emplace_object.
+	template <class T>
+	struct registered_meta_table
+	{
+	};
+
+	template <class T>
+	void push(lua_State &L, registered_meta_table<T>)
+	{
+		lua::stack s(L);
+		create_default_meta_table<T>(s).release();
 	}
 
 	namespace detail
@@ -72,11 +122,9 @@ namespace lua
 		template <class Result, class Class, class ...Args> \
 		stack_value register_method(lua::stack &s, Result (Class::*method)(Args...) constness) \
 		{ \
-			return register_any_function(s, [method](void *this_, Args ...args) -> Result \
+			return register_any_function(s, [method](method_this<Class> this_, Args ...args) -> Result \
 			{ \
-				Class * const raw_this = static_cast<Class *>(this_); \
-				assert(raw_this); \
-				return (raw_this->*method)(std::forward<Args>(args)...); \
+				return (this_.object->*method)(std::forward<Args>(args)...); \
 			}); \
 		}
 
@@ -90,20 +138,24 @@ namespace lua
 		template <class T>
 		struct from_user_data<T &>
 		{
-			T &operator()(void *user_data) const
+			typedef T object_type;
+
+			T &operator()(method_this<T> this_) const
 			{
-				assert(user_data);
-				return *static_cast<T *>(user_data);
+				assert(this_.object);
+				return *this_.object;
 			}
 		};
 
 		template <class T>
 		struct from_user_data<T *>
 		{
-			T *operator()(void *user_data) const
+			typedef T object_type;
+
+			T *operator()(method_this<T> this_) const
 			{
-				assert(user_data);
-				return static_cast<T *>(user_data);
+				assert(this_.object);
+				return this_.object;
 			}
 		};
 
@@ -111,9 +163,8 @@ namespace lua
 		template <class Functor, class Result, class Class, class Arg0, class ...Args> \
 		stack_value register_method_from_functor(lua::stack &s, Functor &&functor, Result (Class::*)(Arg0, Args...) constness) \
 		{ \
-			return register_any_function(s, [functor](void *this_, Args ...args) mutableness -> Result \
+			return register_any_function(s, [functor](method_this<typename from_user_data<Arg0>::object_type> this_, Args ...args) mutableness -> Result \
 			{ \
-				assert(this_); \
 				auto &&raw_this = from_user_data<Arg0>()(this_); \
 				return functor(raw_this, std::forward<Args>(args)...); \
 			}); \
@@ -141,11 +192,14 @@ namespace lua
 		);
 	}
 
+	///For objects created with emplace_object. Does not check the type in release builds. Use to_object when the value
+	///may be of a different type or a box from push_shared or push_borrowed.
 	template <class T>
 	T &assume_type(any_local const &local)
 	{
 		void *data = lua_touserdata(local.thread(), local.from_bottom());
 		assert(data);
+		assert(to_object<T>(*local.thread(), local.from_bottom()) == data);
 		return *static_cast<T *>(data);
 	}
 }
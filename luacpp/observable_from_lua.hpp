@@ -65,9 +65,10 @@ namespace lua
 	{
 		lua::stack s(stack);
 		typedef observable_from_lua<Observable> wrapper;
-		auto meta = lua::create_default_meta_table<wrapper>(s);
-		add_method(s, meta, "async_get_one", &wrapper::async_get_one);
-		return meta;
+		return lua::create_default_meta_table<wrapper>(s, [&s](stack_value &meta)
+		{
+			add_method(s, meta, "async_get_one", &wrapper::async_get_one);
+		});
 	}
 
 	template <class Observable>
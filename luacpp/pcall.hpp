@@ -3,17 +3,107 @@
 
 #include "luacpp/stack_value.hpp"
 #include "luacpp/exception.hpp"
+#include "luacpp/error.hpp"
+#include <silicium/detail/integer_sequence.hpp>
+#include <boost/concept_check.hpp>
+#include <tuple>
 
 namespace lua
 {
+	namespace detail
+	{
+		inline void *message_handler_key() BOOST_NOEXCEPT
+		{
+			static char const key = 0;
+			return const_cast<char *>(&key);
+		}
+
+		///The message handler of all calls made by luacpp. It appends a traceback to string messages.
+		///Because Lua runs it only when there is an error, successful calls do not pay for the traceback.
+		inline int append_traceback(lua_State *L)
+		{
+			if (!lua_isstring(L, 1))
+			{
+				//other error objects are passed through unchanged
+				return 1;
+			}
+			int const max_levels = 32;
+			lua_settop(L, 1);
+			lua_pushliteral(L, "\nstack traceback:");
+			lua_Debug info;
+			int level = 1;
+			for (; (level <= max_levels) && lua_getstack(L, level, &info); ++level)
+			{
+				lua_getinfo(L, "Sln", &info);
+				lua_pushfstring(L, "\n\t%s:", info.short_src);
+				if (info.currentline > 0)
+				{
+					lua_pushfstring(L, "%d:", info.currentline);
+				}
+				if (*info.namewhat != '\0')
+				{
+					lua_pushfstring(L, " in function '%s'", info.name);
+				}
+				else if (*info.what == 'm')
+				{
+					lua_pushliteral(L, " in main chunk");
+				}
+				else if ((*info.what == 'C') || (*info.what == 't'))
+				{
+					lua_pushliteral(L, " ?");
+				}
+				else
+				{
+					lua_pushfstring(L, " in function <%s:%d>", info.short_src, info.linedefined);
+				}
+				lua_concat(L, lua_gettop(L));
+			}
+			if (lua_getstack(L, level, &info))
+			{
+				lua_pushliteral(L, "\n\t...");
+			}
+			lua_concat(L, lua_gettop(L));
+			return 1;
+		}
+
+		///The handler is created once per state and kept in the registry.
+		inline void push_message_handler(lua_State &L)
+		{
+			lua_pushlightuserdata(&L, message_handler_key());
+			lua_rawget(&L, LUA_REGISTRYINDEX);
+			if (!lua_isnil(&L, -1))
+			{
+				return;
+			}
+			lua_pop(&L, 1);
+			lua_pushcfunction(&L, append_traceback);
+			lua_pushlightuserdata(&L, message_handler_key());
+			lua_pushvalue(&L, -2);
+			lua_rawset(&L, LUA_REGISTRYINDEX);
+		}
+	}
+
+	///Like lua_pcall, but with a message handler that adds a traceback to the error message.
+	///The stack looks exactly like after lua_pcall.
+	inline int pcall_with_traceback(lua_State &L, int arguments, int results)
+	{
+		int const function = lua_gettop(&L) - arguments;
+		assert(function >= 1);
+		detail::push_message_handler(L);
+		lua_insert(&L, function);
+		int const rc = lua_pcall(&L, arguments, results, function);
+		lua_remove(&L, function);
+		return rc;
+	}
+
 	inline void handle_pcall_result(lua_State &L, int rc)
 	{
 		if (rc == 0)
 		{
 			return;
 		}
-		//TODO: stack trace in case of an error
-		std::string message = lua_tostring(&L, -1);
+		char const * const raw_message = lua_tostring(&L, -1);
+		std::string message = raw_message ? raw_message : (std::string("(error object is a ") + luaL_typename(&L, -1) + " value)");
 		lua_pop(&L, 1);
 		boost::throw_exception(lua_exception(rc, std::move(message)));
 	}
@@ -22,7 +112,7 @@ namespace lua
 	inline stack_array pcall(lua_State &L, int arguments, boost::optional<int> expected_results)
 	{
 		int stack_before = lua_gettop(&L);
-		int rc = lua_pcall(&L, arguments, expected_results ? *expected_results : LUA_MULTRET, 0);
+		int rc = pcall_with_traceback(L, arguments, expected_results ? *expected_results : LUA_MULTRET);
 		handle_pcall_result(L, rc);
 		assert(lua_gettop(&L) >= (stack_before - 1 - arguments));
 		int result_count = lua_gettop(&L) - stack_before + 1 + arguments;
@@ -30,6 +120,37 @@ namespace lua
 		return stack_array(L, size(L) - result_count + 1, variable<int>{result_count});
 	}
 
+	///The outcome of a call that reports Lua errors without throwing.
+	struct call_result
+	{
+		boost::system::error_code error;
+
+		///the value passed to error(), empty if the call succeeded
+		stack_value error_value;
+
+		///empty if the call failed
+		stack_array results;
+	};
+
+	///Like pcall, but a Lua error is returned instead of thrown. This is meant for errors that are part of the
+	///normal control flow, so no traceback is added to the error value.
+	SILICIUM_USE_RESULT
+	inline call_result try_pcall(lua_State &L, int arguments, boost::optional<int> expected_results)
+	{
+		int const function = lua_gettop(&L) - arguments;
+		assert(function >= 1);
+		int const rc = lua_pcall(&L, arguments, expected_results ? *expected_results : LUA_MULTRET, 0);
+		call_result result;
+		if (rc != 0)
+		{
+			result.error = boost::system::error_code(rc, get_lua_error_category());
+			result.error_value = stack_value(L, lua_gettop(&L));
+			return result;
+		}
+		result.results = stack_array(L, function, variable<int>{lua_gettop(&L) - function + 1});
+		return result;
+	}
+
 	namespace detail
 	{
 		inline void push_all(lua_State &)
@@ -43,6 +164,14 @@ namespace lua
 			push(stack, std::forward<Head>(head));
 			push_all(stack, std::forward<Tail>(tail)...);
 		}
+
+		template <class Tuple, std::size_t ...Indices>
+		void push_elements(lua_State &L, Tuple &&elements, ranges::v3::integer_sequence<Indices...>)
+		{
+			using lua::push;
+			int const pushed[] = {0, (push(L, std::get<Indices>(std::forward<Tuple>(elements))), 0)...};
+			boost::ignore_unused_variable_warning(pushed);
+		}
 	}
 
 	template <class Function, class ...Arguments>
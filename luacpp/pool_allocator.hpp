@@ -0,0 +1,206 @@
+#ifndef LUACPP_POOL_ALLOCATOR_HPP
+#define LUACPP_POOL_ALLOCATOR_HPP
+
+#include "luacpp/stack.hpp"
+#include <boost/noncopyable.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+namespace lua
+{
+	///An allocator for create_lua that serves the many small blocks Lua allocates
+	///(strings, tables, closures, userdata) from free lists, one list per size class.
+	///Bigger blocks go to malloc. Memory of the pools is given back when the allocator
+	///is destroyed, so an instance should be used for exactly one lua_State.
+	///A malloc'd block that cannot be moved into a pool when Lua shrinks it is adopted by the pools and freed by the
+	///destructor, too.
+	struct pool_allocator : private boost::noncopyable
+	{
+		static std::size_t const granularity = 16;
+		static std::size_t const class_count = 16;
+		static std::size_t const max_pooled_size = granularity * class_count;
+		static std::size_t const chunk_size = 64 * 1024;
+
+		pool_allocator() BOOST_NOEXCEPT
+			: m_chunks(nullptr)
+			, m_adopted(nullptr)
+			, m_unused_begin(nullptr)
+			, m_unused_end(nullptr)
+		{
+			m_free.fill(nullptr);
+		}
+
+		~pool_allocator() BOOST_NOEXCEPT
+		{
+			while (m_chunks)
+			{
+				free_block * const next = m_chunks->next;
+				std::free(m_chunks);
+				m_chunks = next;
+			}
+			while (m_adopted)
+			{
+				free_block * const next = m_adopted->next;
+				std::free(reinterpret_cast<char *>(m_adopted) - max_pooled_size);
+				m_adopted = next;
+			}
+		}
+
+		void *reallocate(void *block, std::size_t old_size, std::size_t new_size) BOOST_NOEXCEPT
+		{
+			if (new_size == 0)
+			{
+				deallocate(block, old_size);
+				return nullptr;
+			}
+			if (!block)
+			{
+				return allocate(new_size);
+			}
+			if (is_pooled(old_size) && is_pooled(new_size))
+			{
+				if (size_class(old_size) == size_class(new_size))
+				{
+					return block;
+				}
+			}
+			else if (!is_pooled(old_size) && !is_pooled(new_size))
+			{
+				return std::realloc(block, unpooled_size(new_size));
+			}
+			void * const moved = allocate(new_size);
+			if (!moved)
+			{
+				if (new_size > old_size)
+				{
+					return nullptr;
+				}
+				//lua_Alloc must not fail when shrinking, and the old block is big enough. Lua frees it with the
+				//smaller size later, so a malloc'd block ends up in a pool and has to be freed by the destructor.
+				if (!is_pooled(old_size))
+				{
+					adopt(block);
+				}
+				return block;
+			}
+			std::memcpy(moved, block, (std::min)(old_size, new_size));
+			deallocate(block, old_size);
+			return moved;
+		}
+
+	private:
+
+		struct free_block
+		{
+			free_block *next;
+		};
+
+		BOOST_STATIC_ASSERT(sizeof(free_block) <= granularity);
+
+		std::array<free_block *, class_count> m_free;
+		free_block *m_chunks;
+
+		///malloc'd blocks that belong to the pools, linked behind their pooled part
+		free_block *m_adopted;
+
+		char *m_unused_begin;
+		char *m_unused_end;
+
+		///Every malloc'd block has room for a link behind the part that a pool would use (see adopt).
+		static std::size_t const min_unpooled_size = max_pooled_size + sizeof(free_block);
+
+		static std::size_t unpooled_size(std::size_t size) BOOST_NOEXCEPT
+		{
+			if (size < min_unpooled_size)
+			{
+				return min_unpooled_size;
+			}
+			return size;
+		}
+
+		static bool is_pooled(std::size_t size) BOOST_NOEXCEPT
+		{
+			return size <= max_pooled_size;
+		}
+
+		static std::size_t size_class(std::size_t size) BOOST_NOEXCEPT
+		{
+			assert(size >= 1);
+			assert(is_pooled(size));
+			return (size - 1) / granularity;
+		}
+
+		void *allocate(std::size_t size) BOOST_NOEXCEPT
+		{
+			if (!is_pooled(size))
+			{
+				return std::malloc(unpooled_size(size));
+			}
+			free_block *&free_list = m_free[size_class(size)];
+			if (free_list)
+			{
+				free_block * const reused = free_list;
+				free_list = reused->next;
+				return reused;
+			}
+			std::size_t const rounded_size = (size_class(size) + 1) * granularity;
+			if (static_cast<std::size_t>(m_unused_end - m_unused_begin) < rounded_size)
+			{
+				if (!allocate_chunk())
+				{
+					return nullptr;
+				}
+			}
+			void * const carved = m_unused_begin;
+			m_unused_begin += rounded_size;
+			return carved;
+		}
+
+		void deallocate(void *block, std::size_t size) BOOST_NOEXCEPT
+		{
+			if (!block)
+			{
+				return;
+			}
+			if (!is_pooled(size))
+			{
+				std::free(block);
+				return;
+			}
+			free_block *&free_list = m_free[size_class(size)];
+			free_block * const freed = static_cast<free_block *>(block);
+			freed->next = free_list;
+			free_list = freed;
+		}
+
+		///A block in a pool is used for at most max_pooled_size bytes, so the rest of a malloc'd block can hold the
+		///link that lets the destructor find it.
+		void adopt(void *block) BOOST_NOEXCEPT
+		{
+			free_block * const link = reinterpret_cast<free_block *>(static_cast<char *>(block) + max_pooled_size);
+			link->next = m_adopted;
+			m_adopted = link;
+		}
+
+		bool allocate_chunk() BOOST_NOEXCEPT
+		{
+			//The first granule of every chunk links the chunks together so that the destructor can find them.
+			char * const chunk = static_cast<char *>(std::malloc(chunk_size));
+			if (!chunk)
+			{
+				return false;
+			}
+			free_block * const header = reinterpret_cast<free_block *>(chunk);
+			header->next = m_chunks;
+			m_chunks = header;
+			m_unused_begin = chunk + granularity;
+			m_unused_end = chunk + chunk_size;
+			return true;
+		}
+	};
+}
+
+#endif
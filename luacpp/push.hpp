@@ -7,6 +7,8 @@
 #include <silicium/config.hpp>
 #include <silicium/fast_variant.hpp>
 #include <silicium/memory_range.hpp>
+#include <array>
+#include <vector>
 
 namespace lua
 {
@@ -89,6 +91,18 @@ namespace lua
 		push(L, std::forward<PushFunction>(push_one)(L));
 	}
 
+	///Specialized by LUA_CPP_STRUCT (see luacpp/struct.hpp) for structs that are pushed as tables.
+	template <class T>
+	struct struct_description
+	{
+	};
+
+	template <class T, class = decltype(struct_description<T>::push(std::declval<lua_State &>(), std::declval<T const &>()))>
+	void push(lua_State &L, T const &value)
+	{
+		struct_description<T>::push(L, value);
+	}
+
 	namespace detail
 	{
 		struct pusher
@@ -111,6 +125,40 @@ namespace lua
 		return Si::apply_visitor(detail::pusher{&L}, value);
 	}
 
+	template <class T, class Allocator>
+	void push(lua_State &L, std::vector<T, Allocator> const &elements);
+
+	template <class T, std::size_t N>
+	void push(lua_State &L, std::array<T, N> const &elements);
+
+	namespace detail
+	{
+		template <class Iterator>
+		void push_array(lua_State &L, Iterator begin, std::size_t size)
+		{
+			lua_createtable(&L, static_cast<int>(size), 0);
+			for (std::size_t i = 0; i < size; ++i, ++begin)
+			{
+				using lua::push;
+				push(L, *begin);
+				lua_rawseti(&L, -2, static_cast<int>(i + 1));
+			}
+		}
+	}
+
+	///pushes a new table with the elements at the indices 1 to size()
+	template <class T, class Allocator>
+	void push(lua_State &L, std::vector<T, Allocator> const &elements)
+	{
+		detail::push_array(L, elements.begin(), elements.size());
+	}
+
+	template <class T, std::size_t N>
+	void push(lua_State &L, std::array<T, N> const &elements)
+	{
+		detail::push_array(L, elements.begin(), N);
+	}
+
 	struct any_local : pushable
 	{
 		any_local() BOOST_NOEXCEPT
@@ -7,6 +7,8 @@
 #include "luacpp/coroutine.hpp"
 #include <silicium/detail/integer_sequence.hpp>
 #include <silicium/optional.hpp>
+#include <boost/concept_check.hpp>
+#include <tuple>
 
 namespace lua
 {
@@ -29,11 +31,19 @@ namespace lua
 
 	namespace detail
 	{
+		///Every argument of a call gets its own converter. check is called for all arguments before the first one is
+		///converted. Arguments that can be converted without a check are accepted. A failed check pushes an error
+		///message.
 		template <class T>
 		struct argument_converter
 		{
 			static BOOST_CONSTEXPR_OR_CONST bool consumes_stack = true;
 
+			bool check(lua_State &, int) const BOOST_NOEXCEPT
+			{
+				return true;
+			}
+
 			T operator()(current_thread const &env, int address) const
 			{
 				return from_lua_cast<T>(*env.L, address);
@@ -50,6 +60,11 @@ namespace lua
 		{
 			static BOOST_CONSTEXPR_OR_CONST bool consumes_stack = false;
 
+			bool check(lua_State &, int) const BOOST_NOEXCEPT
+			{
+				return true;
+			}
+
 			current_thread operator()(current_thread const &env, int) const
 			{
 				return env;
@@ -61,12 +76,69 @@ namespace lua
 		{
 			static BOOST_CONSTEXPR_OR_CONST bool consumes_stack = false;
 
+			bool check(lua_State &, int) const BOOST_NOEXCEPT
+			{
+				return true;
+			}
+
 			lua_State &operator()(current_thread const &env, int) const
 			{
 				return *env.L;
 			}
 		};
 
+		///The object a method is called on. The argument is checked with to_object before the method is called, so the
+		///object can also be a box from push_shared or push_borrowed.
+		template <class T>
+		struct method_this
+		{
+			T *object;
+		};
+
+		///The object is looked up only once by the check and remembered for the conversion.
+		template <class T>
+		struct argument_converter<method_this<T>>
+		{
+			static BOOST_CONSTEXPR_OR_CONST bool consumes_stack = true;
+
+			argument_converter() BOOST_NOEXCEPT
+				: m_object(nullptr)
+			{
+			}
+
+			bool check(lua_State &L, int address) BOOST_NOEXCEPT
+			{
+				m_object = to_object<typename std::remove_const<T>::type>(L, address);
+				if (m_object)
+				{
+					return true;
+				}
+				lua_pushfstring(&L, "bad argument #%d (user data of the wrong type, got %s)", address, luaL_typename(&L, address));
+				return false;
+			}
+
+			method_this<T> operator()(current_thread const &, int) const
+			{
+				assert(m_object);
+				return method_this<T>{m_object};
+			}
+
+		private:
+
+			T *m_object;
+		};
+
+		template <class Converters, std::size_t ...Indices>
+		bool check_arguments(lua_State &L, Converters &converters, ranges::v3::integer_sequence<Indices...>) BOOST_NOEXCEPT
+		{
+			bool valid = true;
+			//stops at the first invalid argument, so there is at most one error message
+			bool const expansion[] = {true, (valid = valid && std::get<Indices>(converters).check(L, static_cast<int>(1 + Indices)))...};
+			boost::ignore_unused_variable_warning(expansion);
+			boost::ignore_unused_variable_warning(converters);
+			return valid;
+		}
+
 		template <class ...Arguments>
 		struct argument_count_on_stack;
 
@@ -92,7 +164,12 @@ namespace lua
 			result_or_yield call(Function &func, current_thread const &env, ranges::v3::integer_sequence<Indices...>) const
 			{
 				assert(!env.suspend_requested || !*env.suspend_requested); //TODO
-				NonVoid result = func(argument_converter<Parameters>()(env, 1 + Indices)...);
+				std::tuple<argument_converter<Parameters>...> converters;
+				if (!check_arguments(*env.L, converters, ranges::v3::integer_sequence<Indices...>()))
+				{
+					return raise_error();
+				}
+				NonVoid result = func(std::get<Indices>(converters)(env, 1 + Indices)...);
 				push(*env.L, std::move(result));
 				int arguments_on_stack = argument_count_on_stack<Parameters...>::value;
 				if (arguments_on_stack)
@@ -104,13 +181,52 @@ namespace lua
 			}
 		};
 
+		///Functions returning a tuple or a pair return every element as a separate value.
+		///The arguments stay below the results because Lua only looks at the top of the stack.
+		template <class Tuple, std::size_t Size>
+		struct multiple_results_caller
+		{
+			//Lua guarantees LUA_MINSTACK free slots to a C function
+			BOOST_STATIC_ASSERT(Size <= LUA_MINSTACK);
+
+			template <class ...Parameters, std::size_t ...Indices, class Function>
+			result_or_yield call(Function &func, current_thread const &env, ranges::v3::integer_sequence<Indices...>) const
+			{
+				//every call starts with a fresh flag, so nothing can have requested a suspension yet
+				assert(!env.suspend_requested || !*env.suspend_requested);
+				std::tuple<argument_converter<Parameters>...> converters;
+				if (!check_arguments(*env.L, converters, ranges::v3::integer_sequence<Indices...>()))
+				{
+					return raise_error();
+				}
+				Tuple result = func(std::get<Indices>(converters)(env, 1 + Indices)...);
+				push_elements(*env.L, std::move(result), typename ranges::v3::make_integer_sequence<Size>::type());
+				return static_cast<int>(Size);
+			}
+		};
+
+		template <class ...Elements>
+		struct caller<std::tuple<Elements...>> : multiple_results_caller<std::tuple<Elements...>, sizeof...(Elements)>
+		{
+		};
+
+		template <class First, class Second>
+		struct caller<std::pair<First, Second>> : multiple_results_caller<std::pair<First, Second>, 2>
+		{
+		};
+
 		template <>
 		struct caller<void>
 		{
 			template <class ...Parameters, std::size_t ...Indices, class Function>
 			result_or_yield call(Function &func, current_thread const &env, ranges::v3::integer_sequence<Indices...>) const
 			{
-				func(argument_converter<Parameters>()(env, 1 + Indices)...);
+				std::tuple<argument_converter<Parameters>...> converters;
+				if (!check_arguments(*env.L, converters, ranges::v3::integer_sequence<Indices...>()))
+				{
+					return raise_error();
+				}
+				func(std::get<Indices>(converters)(env, 1 + Indices)...);
 				int arguments_on_stack = argument_count_on_stack<Parameters...>::value;
 				if (arguments_on_stack)
 				{
@@ -153,6 +269,23 @@ namespace lua
 				return caller<R>().template call<Parameters...>(func, env, typename ranges::v3::make_integer_sequence<sizeof...(Parameters)>::type());
 			});
 		}
+
+		template <class FunctionPointer, FunctionPointer Function>
+		struct static_function;
+
+		template <class R, class ...Parameters, R (*Function)(Parameters...)>
+		struct static_function<R (*)(Parameters...), Function>
+		{
+			static int call(lua_State *L) BOOST_NOEXCEPT
+			{
+				bool suspend_requested = false;
+				current_thread env{L, &suspend_requested};
+				//the pointer is a constant, so the compiler can inline the function here
+				R (*function)(Parameters...) = Function;
+				int const command = to_command(caller<R>().template call<Parameters...>(function, env, typename ranges::v3::make_integer_sequence<sizeof...(Parameters)>::type()));
+				return execute_command(L, command);
+			}
+		};
 	}
 
 	template <class Function>
@@ -162,6 +295,17 @@ namespace lua
 		auto call_operator = &clean_function::operator();
 		return detail::register_any_function_helper<clean_function>(s, std::forward<Function>(f), call_operator);
 	}
+
+	///Like register_any_function for a free function that is known at compile time. The arguments are converted the
+	///same way, but the generated lua_CFunction has no upvalue, so there is no user data and no meta table.
+	///LUA_CPP_REGISTER_FUNCTION saves spelling out the type of the function pointer.
+	template <class FunctionPointer, FunctionPointer Function>
+	stack_value register_function(lua_State &L)
+	{
+		return register_function(L, detail::static_function<FunctionPointer, Function>::call);
+	}
 }
 
+#define LUA_CPP_REGISTER_FUNCTION(state, function) ::lua::register_function<decltype(&function), &function>(state)
+
 #endif
@@ -54,13 +54,7 @@ namespace lua
 #ifndef NDEBUG
 				int initial_stack_size = size(*thread.L);
 #endif
-				auto meta = create_default_meta_table<operation_type>(s);
-				assert(initial_stack_size + 1 == size(*thread.L));
-
-				auto object = emplace_object<operation_type>(s, meta, main, std::move(*coro), std::move(observable));
-				assert(initial_stack_size + 2 == size(*thread.L));
-
-				replace(object, meta);
+				auto object = emplace_object<operation_type>(s, registered_meta_table<operation_type>(), main, std::move(*coro), std::move(observable));
 				assert(initial_stack_size + 1 == size(*thread.L));
 
 				auto &operation = assume_type<operation_type>(object);
@@ -2,7 +2,10 @@
 #define LUACPP_REGISTER_CLOSURE_HPP
 
 #include "luacpp/stack.hpp"
+#include "luacpp/type_registry.hpp"
 #include <silicium/source/empty.hpp>
+#include <boost/mpl/bool.hpp>
+#include <type_traits>
 
 namespace lua
 {
@@ -10,37 +13,70 @@ namespace lua
 	{
 	};
 
-	typedef Si::fast_variant<int, yield> result_or_yield;
+	///The error value is on top of the stack. lua_error is called after the C++ function has returned, so that no
+	///destructor is skipped.
+	struct raise_error
+	{
+	};
+
+	typedef Si::fast_variant<int, yield, raise_error> result_or_yield;
 
 	namespace detail
 	{
+		BOOST_CONSTEXPR_OR_CONST int yield_command = -1;
+		BOOST_CONSTEXPR_OR_CONST int raise_error_command = -2;
+
+		///the number of results or one of the negative command constants
+		inline int to_command(result_or_yield const &command) BOOST_NOEXCEPT
+		{
+			int result = 0;
+			Si::visit<void>(
+				command,
+				[&result](int rc)
+				{
+					assert(rc >= 0);
+					result = rc;
+				},
+				[&result](yield)
+				{
+					result = yield_command;
+				},
+				[&result](raise_error)
+				{
+					result = raise_error_command;
+				}
+			);
+			return result;
+		}
+
+		///Translates the command of a C++ function into the return value of a lua_CFunction. The result_or_yield
+		///has to be destroyed before this is called because lua_error does not return.
+		inline int execute_command(lua_State *L, int command) BOOST_NOEXCEPT
+		{
+			switch (command)
+			{
+			case yield_command:
+				assert(lua_gettop(L) == 0);
+				return lua_yield(L, 0);
+
+			case raise_error_command:
+				return lua_error(L);
+
+			default:
+				return command;
+			}
+		}
+
 		template <class Function>
 		int call_upvalue_function(lua_State *L) BOOST_NOEXCEPT
 		{
-			int result;
-			bool yielding = false;
+			int command;
 			{
 				Function * const f_stored = static_cast<Function *>(lua_touserdata(L, lua_upvalueindex(1)));
 				assert(f_stored);
-				result_or_yield command = (*f_stored)(L);
-				Si::visit<void>(
-					command,
-					[&result](int rc)
-					{
-						result = rc;
-					},
-					[&yielding](yield)
-					{
-						yielding = true;
-					}
-				);
+				command = to_command((*f_stored)(L));
 			}
-			if (yielding)
-			{
-				assert(lua_gettop(L) == 0);
-				return lua_yield(L, 0);
-			}
-			return result;
+			return execute_command(L, command);
 		}
 
 		template <class Function>
@@ -68,6 +104,32 @@ namespace lua
 				object->~T();
 			}
 		};
+
+		///distinguishes the meta table of a stored closure from a meta table that is registered for the type itself
+		template <class Function>
+		struct closure_meta_table_tag
+		{
+		};
+
+		template <class Function>
+		void set_closure_meta_table(stack &, stack_value &, boost::mpl::bool_<true>)
+		{
+			//nothing to finalize, so the collector does not have to treat the user data specially
+		}
+
+		template <class Function>
+		void set_closure_meta_table(stack &s, stack_value &data, boost::mpl::bool_<false>)
+		{
+			stack_value meta_table = get_or_create_meta_table(
+				*s.state(),
+				type_key<closure_meta_table_tag<Function>>(),
+				[&s](stack_value &meta)
+			{
+				stack_value destructor = register_function(*s.state(), delete_function<Function>);
+				set_element(meta, "__gc", destructor);
+			});
+			set_meta_table(data, meta_table);
+		}
 	}
 
 	template <class Function, class UpvalueSource>
@@ -80,15 +142,11 @@ namespace lua
 			assert(f_stored);
 			new (f_stored) clean_function{std::forward<Function>(f)};
 			std::unique_ptr<clean_function, detail::placement_destructor> f_stored_handle(f_stored);
-			{
-				stack_value meta_table = create_table(*s.state());
-				//TODO: cache metatable
-				{
-					stack_value destructor = register_function(*s.state(), detail::delete_function<clean_function>);
-					set_element(meta_table, "__gc", destructor);
-				}
-				set_meta_table(data, meta_table);
-			}
+			detail::set_closure_meta_table<clean_function>(
+				s,
+				data,
+				boost::mpl::bool_<std::is_trivially_destructible<clean_function>::value>()
+			);
 			f_stored_handle.release();
 		}
 		int upvalue_count = 1;
@@ -0,0 +1,206 @@
+#ifndef LUACPP_REGISTER_OVERLOADS_HPP
+#define LUACPP_REGISTER_OVERLOADS_HPP
+
+#include "luacpp/register_any_function.hpp"
+#include <boost/cstdint.hpp>
+#include <array>
+#include <tuple>
+
+namespace lua
+{
+	namespace detail
+	{
+		///the argument signature of a call has four bits per argument for lua_type + 1
+		BOOST_CONSTEXPR_OR_CONST int max_overload_arguments = 16;
+
+		template <class T, class = void>
+		struct expected_lua_type
+		{
+			//any_local, fast_variant and the like accept every type
+			static BOOST_CONSTEXPR_OR_CONST bool is_any = true;
+			static BOOST_CONSTEXPR_OR_CONST int value = LUA_TNONE;
+		};
+
+		template <class T>
+		struct expected_lua_type<T, typename std::enable_if<sizeof(from_lua<T>::lua_type) != 0>::type>
+		{
+			static BOOST_CONSTEXPR_OR_CONST bool is_any = false;
+			static BOOST_CONSTEXPR_OR_CONST int value = static_cast<int>(from_lua<T>::lua_type);
+		};
+
+		///Computes which bits of the signature have to be equal to which value for the parameters to match. The index
+		///of a parameter is its address on the stack minus one, like in caller.
+		template <std::size_t Index, class ...Parameters>
+		struct overload_pattern
+		{
+			static BOOST_CONSTEXPR_OR_CONST boost::uint64_t mask = 0;
+			static BOOST_CONSTEXPR_OR_CONST boost::uint64_t pattern = 0;
+		};
+
+		template <std::size_t Index, class First, class ...Rest>
+		struct overload_pattern<Index, First, Rest...>
+		{
+		private:
+
+			typedef typename std::decay<First>::type clean;
+			typedef overload_pattern<Index + 1, Rest...> rest;
+			static BOOST_CONSTEXPR_OR_CONST bool is_checked = argument_converter<First>::consumes_stack && !expected_lua_type<clean>::is_any;
+			static BOOST_CONSTEXPR_OR_CONST unsigned shift = static_cast<unsigned>(Index * 4);
+
+		public:
+
+			static BOOST_CONSTEXPR_OR_CONST boost::uint64_t mask = (is_checked ? (boost::uint64_t(0xf) << shift) : 0) | rest::mask;
+			static BOOST_CONSTEXPR_OR_CONST boost::uint64_t pattern =
+				(is_checked ? (static_cast<boost::uint64_t>(expected_lua_type<clean>::value + 1) << shift) : 0) | rest::pattern;
+		};
+
+		struct overload_entry
+		{
+			int arity;
+			boost::uint64_t mask;
+			boost::uint64_t pattern;
+			result_or_yield (*call)(void *overloads, lua_State *L);
+		};
+
+		template <class F, class R, class ...Parameters>
+		overload_entry make_overload_entry(result_or_yield (*call)(void *, lua_State *), R (F::*)(Parameters...) const)
+		{
+			BOOST_STATIC_ASSERT(sizeof...(Parameters) <= max_overload_arguments);
+			return overload_entry{argument_count_on_stack<Parameters...>::value, overload_pattern<0, Parameters...>::mask, overload_pattern<0, Parameters...>::pattern, call};
+		}
+
+		template <class F, class R, class ...Parameters>
+		overload_entry make_overload_entry(result_or_yield (*call)(void *, lua_State *), R (F::*)(Parameters...))
+		{
+			BOOST_STATIC_ASSERT(sizeof...(Parameters) <= max_overload_arguments);
+			return overload_entry{argument_count_on_stack<Parameters...>::value, overload_pattern<0, Parameters...>::mask, overload_pattern<0, Parameters...>::pattern, call};
+		}
+
+		template <class F, class R, class ...Parameters>
+		result_or_yield call_overload(F &function, lua_State *L, R (F::*)(Parameters...) const)
+		{
+			bool suspend_requested = false;
+			current_thread env{L, &suspend_requested};
+			return caller<R>().template call<Parameters...>(function, env, typename ranges::v3::make_integer_sequence<sizeof...(Parameters)>::type());
+		}
+
+		template <class F, class R, class ...Parameters>
+		result_or_yield call_overload(F &function, lua_State *L, R (F::*)(Parameters...))
+		{
+			bool suspend_requested = false;
+			current_thread env{L, &suspend_requested};
+			return caller<R>().template call<Parameters...>(function, env, typename ranges::v3::make_integer_sequence<sizeof...(Parameters)>::type());
+		}
+
+		template <class Overloads>
+		struct overload_set;
+
+		template <class ...Functions>
+		struct overload_set<std::tuple<Functions...>>
+		{
+			typedef std::tuple<Functions...> overloads;
+
+			static int dispatch(lua_State *L) BOOST_NOEXCEPT
+			{
+				static std::array<overload_entry, sizeof...(Functions)> const entries =
+					make_entries(typename ranges::v3::make_integer_sequence<sizeof...(Functions)>::type());
+				int const overload = find(*L, entries);
+				if (overload < 0)
+				{
+					//no C++ object with a destructor is alive here, so it is safe to leave with lua_error
+					push_mismatch_message(*L);
+					return lua_error(L);
+				}
+				void * const stored = lua_touserdata(L, lua_upvalueindex(1));
+				assert(stored);
+				int const command = to_command(entries[static_cast<std::size_t>(overload)].call(stored, L));
+				return execute_command(L, command);
+			}
+
+		private:
+
+			template <std::size_t Index>
+			static result_or_yield call(void *stored, lua_State *L)
+			{
+				auto &function = std::get<Index>(*static_cast<overloads *>(stored));
+				typedef typename std::tuple_element<Index, overloads>::type function_type;
+				return call_overload(function, L, &function_type::operator());
+			}
+
+			template <std::size_t ...Indices>
+			static std::array<overload_entry, sizeof...(Functions)> make_entries(ranges::v3::integer_sequence<Indices...>)
+			{
+				std::array<overload_entry, sizeof...(Functions)> const entries =
+				{{
+					make_overload_entry(&call<Indices>, &std::tuple_element<Indices, overloads>::type::operator())...
+				}};
+				return entries;
+			}
+
+			///one pass over the arguments, then the first matching overload wins
+			static int find(lua_State &L, std::array<overload_entry, sizeof...(Functions)> const &entries) BOOST_NOEXCEPT
+			{
+				int const arity = lua_gettop(&L);
+				boost::uint64_t signature = 0;
+				int const described = (arity < max_overload_arguments) ? arity : max_overload_arguments;
+				for (int i = 0; i < described; ++i)
+				{
+					signature |= static_cast<boost::uint64_t>(::lua_type(&L, i + 1) + 1) << static_cast<unsigned>(i * 4);
+				}
+				for (std::size_t i = 0; i < entries.size(); ++i)
+				{
+					overload_entry const &entry = entries[i];
+					if ((entry.arity == arity) && ((signature & entry.mask) == entry.pattern))
+					{
+						return static_cast<int>(i);
+					}
+				}
+				return -1;
+			}
+
+			static void push_mismatch_message(lua_State &L) BOOST_NOEXCEPT
+			{
+				int const arity = lua_gettop(&L);
+				lua_pushliteral(&L, "no overload accepts the arguments (");
+				for (int i = 1; i <= arity; ++i)
+				{
+					if (i > 1)
+					{
+						lua_pushliteral(&L, ", ");
+						lua_concat(&L, 2);
+					}
+					lua_pushstring(&L, luaL_typename(&L, i));
+					lua_concat(&L, 2);
+				}
+				lua_pushliteral(&L, ")");
+				lua_concat(&L, 2);
+			}
+		};
+	}
+
+	///Registers one Lua function that calls the first of the functors whose parameters match the number and the
+	///Lua types of the arguments. Parameters like any_local accept every type. A number is not converted to a
+	///string or vice versa for the purpose of matching. If no functor matches, a Lua error is raised.
+	template <class ...Functions>
+	stack_value register_overloads(stack &s, Functions &&...functions)
+	{
+		typedef std::tuple<typename std::decay<Functions>::type...> overloads;
+		stack_value data = create_user_data(*s.state(), sizeof(overloads));
+		{
+			overloads * const stored = static_cast<overloads *>(to_user_data(data));
+			assert(stored);
+			new (stored) overloads{std::forward<Functions>(functions)...};
+			std::unique_ptr<overloads, detail::placement_destructor> stored_handle(stored);
+			detail::set_closure_meta_table<overloads>(
+				s,
+				data,
+				boost::mpl::bool_<std::is_trivially_destructible<overloads>::value>()
+			);
+			stored_handle.release();
+		}
+		data.release();
+		return register_function_with_existing_upvalues(*s.state(), detail::overload_set<overloads>::dispatch, 1);
+	}
+}
+
+#endif
@@ -31,9 +31,10 @@ namespace lua
 	lua::stack_value create_sink_wrapper_meta_table(lua::stack &stack)
 	{
 		typedef sink_from_lua<Sink> wrapper;
-		lua::stack_value table = lua::create_default_meta_table<wrapper>(stack);
-		lua::add_method(stack, table, "append", &wrapper::append);
-		return table;
+		return lua::create_default_meta_table<wrapper>(stack, [&stack](lua::stack_value &table)
+		{
+			lua::add_method(stack, table, "append", &wrapper::append);
+		});
 	}
 }
 
@@ -3,18 +3,36 @@
 
 #include <silicium/sink/sink.hpp>
 #include "luacpp/reference.hpp"
+#include "luacpp/key_cache.hpp"
 
 namespace lua
 {
+	namespace detail
+	{
+		///pushes handler.append, using the interned key if there is one
+		inline void push_append_method(lua_State &L, interned_key append_key)
+		{
+			if (append_key.empty())
+			{
+				lua_getfield(&L, -1, "append");
+				return;
+			}
+			push(L, append_key);
+			lua_gettable(&L, -2);
+		}
+	}
+
 	template <class T>
 	struct sink_into_lua
 	{
 		typedef T element_type;
 		typedef Si::success error_type;
 
-		explicit sink_into_lua(const lua::reference &handler, lua_State &state)
+		///'append_key' is an optional interned "append"
+		explicit sink_into_lua(const lua::reference &handler, lua_State &state, interned_key append_key = interned_key())
 			: m_handler(handler)
 			, m_state(&state)
+			, m_append_key(append_key)
 		{
 			assert(handler.get_type() == type::user_data);
 		}
@@ -25,7 +43,7 @@ namespace lua
 			for (element_type const &element : data)
 			{
 				lua::push(*m_state, m_handler);
-				lua_getfield(m_state, -1, "append");
+				detail::push_append_method(*m_state, m_append_key);
 				lua::push(*m_state, m_handler);
 				lua::push(*m_state, element);
 				lua::pcall(*m_state, 2, 0);
@@ -37,6 +55,7 @@ namespace lua
 
 		const lua::reference &m_handler;
 		lua_State *m_state;
+		interned_key m_append_key;
 	};
 
 	struct text_sink_into_lua
@@ -44,9 +63,11 @@ namespace lua
 		typedef char element_type;
 		typedef Si::success error_type;
 
-		explicit text_sink_into_lua(const lua::reference &handler, lua_State &state)
+		///'append_key' is an optional interned "append"
+		explicit text_sink_into_lua(const lua::reference &handler, lua_State &state, interned_key append_key = interned_key())
 			: m_handler(&handler)
 			, m_state(&state)
+			, m_append_key(append_key)
 		{
 			assert(handler.get_type() == type::user_data);
 		}
@@ -55,7 +76,7 @@ namespace lua
 		{
 			assert(m_state);
 			lua::push(*m_state, *m_handler);
-			lua_getfield(m_state, -1, "append");
+			detail::push_append_method(*m_state, m_append_key);
 			lua::push(*m_state, *m_handler);
 			lua::push(*m_state, data);
 			lua::pcall(*m_state, 2, 0);
@@ -66,6 +87,7 @@ namespace lua
 
 		const lua::reference *m_handler;
 		lua_State *m_state;
+		interned_key m_append_key;
 	};
 }
 
@@ -7,9 +7,37 @@
 #include "luacpp/exception.hpp"
 #include <silicium/source/empty.hpp>
 #include <silicium/fast_variant.hpp>
+#include <silicium/sink/sink.hpp>
+#include <tuple>
+#include <type_traits>
 
 namespace lua
 {
+	template <class T>
+	struct from_lua;
+
+	namespace detail
+	{
+		struct pop_on_exit : private boost::noncopyable
+		{
+			pop_on_exit(lua_State &L, int count) BOOST_NOEXCEPT
+				: m_L(&L)
+				, m_count(count)
+			{
+			}
+
+			~pop_on_exit() BOOST_NOEXCEPT
+			{
+				lua_pop(m_L, m_count);
+			}
+
+		private:
+
+			lua_State *m_L;
+			int m_count;
+		};
+	}
+
 	struct top_checker : boost::noncopyable
 	{
 		explicit top_checker(lua_State &lua)
@@ -67,7 +95,7 @@ namespace lua
 			int const argument_count = push_arguments(function, arguments);
 			assert(size(*m_state) == top_before + argument_count + 1);
 			int const nresults = expected_result_count ? *expected_result_count : LUA_MULTRET;
-			int const rc = lua_pcall(m_state, argument_count, nresults, 0);
+			int const rc = pcall_with_traceback(*m_state, argument_count, nresults);
 			int const top_after_call = size(*m_state);
 			assert(top_after_call >= top_before);
 			if (rc == 0)
@@ -95,6 +123,65 @@ namespace lua
 			return stack_value(*m_state, where);
 		}
 
+		///Like call, but a Lua error is returned instead of thrown. See try_pcall.
+		template <class Pushable, class ArgumentSource>
+		SILICIUM_USE_RESULT
+		call_result try_call(Pushable const &function, ArgumentSource &&arguments, boost::optional<int> expected_result_count)
+		{
+			int const argument_count = push_arguments(function, arguments);
+			return try_pcall(*m_state, argument_count, expected_result_count);
+		}
+
+		///Pushes the function and the arguments directly and converts exactly sizeof...(Results) results which are
+		///popped before returning. Results must not refer to the Lua values (like string_view does).
+		template <class ...Results, class Function, class ...Arguments>
+		typename std::enable_if<(sizeof...(Results) > 0), std::tuple<Results...>>::type
+		call(Function const &function, Arguments &&...arguments)
+		{
+			top_checker checker(*m_state);
+			using lua::push;
+			push(*m_state, function);
+			detail::push_all(*m_state, std::forward<Arguments>(arguments)...);
+			int const rc = pcall_with_traceback(*m_state, static_cast<int>(sizeof...(Arguments)), static_cast<int>(sizeof...(Results)));
+			handle_pcall_result(*m_state, rc);
+			detail::pop_on_exit const results(*m_state, static_cast<int>(sizeof...(Results)));
+			return convert_results<Results...>(size(*m_state) - static_cast<int>(sizeof...(Results)) + 1, typename ranges::v3::make_integer_sequence<sizeof...(Results)>::type());
+		}
+
+		///Calls 'function' once for every tuple from 'argument_tuples' and appends the single result of every call,
+		///converted to Result, to 'results'. The function and the message handler that adds the traceback to errors
+		///are pushed only once for all calls.
+		///Result must not refer to the Lua value (like string_view does) because the value is popped after the append.
+		///Returns the number of calls.
+		template <class Result, class Pushable, class TupleSource, class ResultSink>
+		std::size_t call_many(Pushable const &function, TupleSource &&argument_tuples, ResultSink &&results)
+		{
+			top_checker checker(*m_state);
+			detail::push_message_handler(*m_state);
+			stack_value handler(*m_state, size(*m_state));
+			push(*m_state, function);
+			stack_value resident(*m_state, size(*m_state));
+			std::size_t calls = 0;
+			for (;;)
+			{
+				auto arguments = Si::get(argument_tuples);
+				if (!arguments)
+				{
+					break;
+				}
+				typedef typename std::decay<decltype(*arguments)>::type tuple;
+				int const argument_count = static_cast<int>(std::tuple_size<tuple>::value);
+				lua_pushvalue(m_state, resident.from_bottom());
+				detail::push_elements(*m_state, std::move(*arguments), typename ranges::v3::make_integer_sequence<std::tuple_size<tuple>::value>::type());
+				int const rc = lua_pcall(m_state, argument_count, 1, handler.from_bottom());
+				handle_pcall_result(*m_state, rc);
+				stack_value result(*m_state, size(*m_state));
+				Si::append(results, from_lua<Result>()(*m_state, result.from_bottom()));
+				++calls;
+			}
+			return calls;
+		}
+
 		struct yield
 		{
 		};
@@ -126,6 +213,12 @@ namespace lua
 
 		lua_State *m_state;
 
+		template <class ...Results, std::size_t ...Indices>
+		std::tuple<Results...> convert_results(int first, ranges::v3::integer_sequence<Indices...>) const
+		{
+			return std::tuple<Results...>(from_lua<Results>()(*m_state, first + static_cast<int>(Indices))...);
+		}
+
 		template <class Pushable, class ArgumentSource>
 		int push_arguments(Pushable &&function, ArgumentSource &&arguments)
 		{
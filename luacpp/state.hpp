@@ -8,6 +8,7 @@
 #include <boost/system/error_code.hpp>
 #include <boost/filesystem/path.hpp>
 #include <iostream>
+#include <cstdlib>
 
 namespace lua
 {
@@ -39,6 +40,51 @@ namespace lua
 		return lua;
 	}
 
+	///the allocation policy luaL_newstate uses
+	struct default_allocator
+	{
+		void *reallocate(void *block, std::size_t, std::size_t new_size) BOOST_NOEXCEPT
+		{
+			if (new_size == 0)
+			{
+				std::free(block);
+				return nullptr;
+			}
+			return std::realloc(block, new_size);
+		}
+	};
+
+	namespace detail
+	{
+		template <class Allocator>
+		void *reallocate_with(void *allocator, void *block, std::size_t old_size, std::size_t new_size) BOOST_NOEXCEPT
+		{
+			assert(allocator);
+			return static_cast<Allocator *>(allocator)->reallocate(block, old_size, new_size);
+		}
+
+		inline int print_panic_message(lua_State *L)
+		{
+			char const *message = lua_tostring(L, -1);
+			std::cerr << "PANIC: unprotected error in call to Lua API (" << (message ? message : "?") << ")\n";
+			return 0;
+		}
+	}
+
+	///Creates a state that allocates all of its memory through allocator.reallocate(block, old_size, new_size),
+	///which has the semantics of lua_Alloc. The allocator has to outlive the state.
+	template <class Allocator>
+	state_ptr create_lua(Allocator &allocator)
+	{
+		state_ptr lua(lua_newstate(detail::reallocate_with<Allocator>, &allocator));
+		if (!lua)
+		{
+			throw std::bad_alloc();
+		}
+		lua_atpanic(lua.get(), detail::print_panic_message);
+		return lua;
+	}
+
 	inline void print_stack(std::ostream &out, lua_State &L)
 	{
 		int size = lua_gettop(&L);
@@ -0,0 +1,261 @@
+#ifndef LUACPP_STATE_POOL_HPP
+#define LUACPP_STATE_POOL_HPP
+
+#include "luacpp/stack.hpp"
+#include <boost/noncopyable.hpp>
+#include <functional>
+#include <vector>
+
+namespace lua
+{
+	namespace detail
+	{
+		inline void *state_baseline_key() BOOST_NOEXCEPT
+		{
+			static char const key = 0;
+			return const_cast<char *>(&key);
+		}
+
+		///pushes a new table with the same fields as the table at the absolute index 'original'
+		inline void push_shallow_copy(lua_State &L, int original)
+		{
+			lua_newtable(&L);
+			lua_pushnil(&L);
+			while (lua_next(&L, original) != 0)
+			{
+				lua_pushvalue(&L, -2);
+				lua_insert(&L, -2);
+				lua_rawset(&L, -4);
+			}
+		}
+
+		///makes the fields of the table at the absolute index 'table' equal to those of 'baseline'
+		inline void restore_fields(lua_State &L, int table, int baseline)
+		{
+			lua_pushnil(&L);
+			while (lua_next(&L, table) != 0)
+			{
+				lua_pop(&L, 1);
+				lua_pushvalue(&L, -1);
+				lua_rawget(&L, baseline);
+				bool const is_new = lua_isnil(&L, -1);
+				lua_pop(&L, 1);
+				if (is_new)
+				{
+					//assigning nil to an existing field is allowed during lua_next
+					lua_pushvalue(&L, -1);
+					lua_pushnil(&L);
+					lua_rawset(&L, table);
+				}
+			}
+			lua_pushnil(&L);
+			while (lua_next(&L, baseline) != 0)
+			{
+				lua_pushvalue(&L, -2);
+				lua_insert(&L, -2);
+				lua_rawset(&L, table);
+			}
+		}
+	}
+
+	///Remembers the current globals and registry entries of the state so that reset_to_baseline can restore them.
+	///The stack should be empty.
+	inline void save_baseline(lua_State &L)
+	{
+		assert(lua_gettop(&L) == 0);
+		lua_createtable(&L, 2, 0);
+		lua_pushvalue(&L, LUA_GLOBALSINDEX);
+		detail::push_shallow_copy(L, lua_gettop(&L));
+		lua_rawseti(&L, 1, 1);
+		lua_pop(&L, 1);
+		detail::push_shallow_copy(L, LUA_REGISTRYINDEX);
+		lua_rawseti(&L, 1, 2);
+		lua_pushlightuserdata(&L, detail::state_baseline_key());
+		lua_insert(&L, 1);
+		lua_rawset(&L, LUA_REGISTRYINDEX);
+	}
+
+	///Empties the stack and restores the top-level fields of the globals and the registry to what they were when
+	///save_baseline was called. Registry references created since then are gone, so every lua::reference into
+	///this state has to be destroyed before. The same goes for the keys of a key_cache created after the baseline.
+	///Tables reachable from the globals are not restored recursively.
+	///Restoring a field can allocate, so a memory error raises a Lua error. Use try_reset_to_baseline outside of a
+	///protected call.
+	inline void reset_to_baseline(lua_State &L)
+	{
+		lua_settop(&L, 0);
+		lua_pushlightuserdata(&L, detail::state_baseline_key());
+		lua_rawget(&L, LUA_REGISTRYINDEX);
+		assert(lua_istable(&L, 1));
+		lua_rawgeti(&L, 1, 1);
+		lua_pushvalue(&L, LUA_GLOBALSINDEX);
+		detail::restore_fields(L, 3, 2);
+		lua_settop(&L, 1);
+		lua_rawgeti(&L, 1, 2);
+		detail::restore_fields(L, LUA_REGISTRYINDEX, 2);
+		lua_settop(&L, 1);
+
+		//the baseline itself is not part of the saved registry
+		lua_pushlightuserdata(&L, detail::state_baseline_key());
+		lua_insert(&L, 1);
+		lua_rawset(&L, LUA_REGISTRYINDEX);
+		assert(lua_gettop(&L) == 0);
+	}
+
+	namespace detail
+	{
+		inline int call_reset_to_baseline(lua_State *L)
+		{
+			reset_to_baseline(*L);
+			return 0;
+		}
+	}
+
+	///Like reset_to_baseline, but a Lua error (most likely LUA_ERRMEM) is returned instead of reaching the panic
+	///function. The state is only partially restored if this fails and should be closed.
+	inline int try_reset_to_baseline(lua_State &L) BOOST_NOEXCEPT
+	{
+		lua_settop(&L, 0);
+		int const rc = lua_cpcall(&L, detail::call_reset_to_baseline, nullptr);
+		lua_settop(&L, 0);
+		return rc;
+	}
+
+	struct state_pool;
+
+	///A state borrowed from a state_pool. It goes back into the pool on destruction.
+	struct pooled_state
+	{
+		pooled_state() BOOST_NOEXCEPT
+			: m_pool(nullptr)
+		{
+		}
+
+		pooled_state(state_pool &pool, state_ptr state) BOOST_NOEXCEPT
+			: m_pool(&pool)
+			, m_state(std::move(state))
+		{
+		}
+
+		pooled_state(pooled_state &&other) BOOST_NOEXCEPT
+			: m_pool(other.m_pool)
+			, m_state(std::move(other.m_state))
+		{
+		}
+
+		pooled_state &operator = (pooled_state &&other) BOOST_NOEXCEPT
+		{
+			using std::swap;
+			swap(m_pool, other.m_pool);
+			swap(m_state, other.m_state);
+			return *this;
+		}
+
+		~pooled_state() BOOST_NOEXCEPT;
+
+		lua_State *get() const BOOST_NOEXCEPT
+		{
+			return m_state.get();
+		}
+
+		lua_State &operator *() const BOOST_NOEXCEPT
+		{
+			assert(m_state);
+			return *m_state;
+		}
+
+	private:
+
+		state_pool *m_pool;
+		state_ptr m_state;
+
+		SILICIUM_DELETED_FUNCTION(pooled_state(pooled_state const &))
+		SILICIUM_DELETED_FUNCTION(pooled_state &operator = (pooled_state const &))
+	};
+
+	///Keeps fully initialized states (libraries opened, chunks loaded) around so that a state can be handed out
+	///without paying for the initialization again. A returned state is reset with reset_to_baseline, so registry
+	///references taken while it was borrowed (including those of a key_cache) are invalid afterwards. A state that
+	///cannot be reset is closed instead of being kept. The pool is not thread-safe.
+	struct state_pool : private boost::noncopyable
+	{
+		typedef std::function<void (lua_State &)> initializer;
+
+		explicit state_pool(initializer initialize, std::size_t prepared_count = 0)
+			: m_initialize(std::move(initialize))
+		{
+			assert(m_initialize);
+			prepare(prepared_count);
+		}
+
+		std::size_t idle_count() const BOOST_NOEXCEPT
+		{
+			return m_idle.size();
+		}
+
+		///makes sure that at least 'count' states are ready to be acquired
+		void prepare(std::size_t count)
+		{
+			m_idle.reserve(count);
+			while (m_idle.size() < count)
+			{
+				m_idle.emplace_back(create_initialized());
+			}
+		}
+
+		pooled_state acquire()
+		{
+			if (m_idle.empty())
+			{
+				return pooled_state(*this, create_initialized());
+			}
+			state_ptr state = std::move(m_idle.back());
+			m_idle.pop_back();
+			return pooled_state(*this, std::move(state));
+		}
+
+		void release(state_ptr state) BOOST_NOEXCEPT
+		{
+			assert(state);
+			if (try_reset_to_baseline(*state) != 0)
+			{
+				//the state is closed because it is in an unknown condition
+				return;
+			}
+			try
+			{
+				m_idle.emplace_back(std::move(state));
+			}
+			catch (std::bad_alloc const &)
+			{
+				//the state is closed when it cannot be kept
+			}
+		}
+
+	private:
+
+		initializer m_initialize;
+		std::vector<state_ptr> m_idle;
+
+		state_ptr create_initialized()
+		{
+			state_ptr state = create_lua();
+			m_initialize(*state);
+			lua_settop(state.get(), 0);
+			save_baseline(*state);
+			return state;
+		}
+	};
+
+	inline pooled_state::~pooled_state() BOOST_NOEXCEPT
+	{
+		if (!m_state)
+		{
+			return;
+		}
+		assert(m_pool);
+		m_pool->release(std::move(m_state));
+	}
+}
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef LUACPP_STRING_VIEW_HPP
+#define LUACPP_STRING_VIEW_HPP
+
+#include "luacpp/from_lua_cast.hpp"
+#include "luacpp/reference.hpp"
+#include <silicium/memory_range.hpp>
+#include <silicium/noexcept_string.hpp>
+#include <boost/optional.hpp>
+#include <cstring>
+#include <ostream>
+
+namespace lua
+{
+	///The characters of a Lua string without a copy. Lua never moves a string, so the view is valid as long as the
+	///string is on the stack or reachable otherwise, for example through a reference (see pinned_string_view).
+	struct string_view
+	{
+		string_view() BOOST_NOEXCEPT
+			: m_data("")
+			, m_size(0)
+		{
+		}
+
+		string_view(char const *data, std::size_t size) BOOST_NOEXCEPT
+			: m_data(data)
+			, m_size(size)
+		{
+		}
+
+		char const *data() const BOOST_NOEXCEPT
+		{
+			return m_data;
+		}
+
+		std::size_t size() const BOOST_NOEXCEPT
+		{
+			return m_size;
+		}
+
+		char const *begin() const BOOST_NOEXCEPT
+		{
+			return m_data;
+		}
+
+		char const *end() const BOOST_NOEXCEPT
+		{
+			return m_data + m_size;
+		}
+
+		bool empty() const BOOST_NOEXCEPT
+		{
+			return m_size == 0;
+		}
+
+		Si::memory_range range() const BOOST_NOEXCEPT
+		{
+			return Si::make_memory_range(begin(), end());
+		}
+
+		Si::noexcept_string str() const
+		{
+			return Si::noexcept_string(m_data, m_size);
+		}
+
+	private:
+
+		char const *m_data;
+		std::size_t m_size;
+	};
+
+	inline bool operator == (string_view left, string_view right) BOOST_NOEXCEPT
+	{
+		return (left.size() == right.size()) && (std::memcmp(left.data(), right.data(), left.size()) == 0);
+	}
+
+	inline bool operator != (string_view left, string_view right) BOOST_NOEXCEPT
+	{
+		return !(left == right);
+	}
+
+	inline bool operator == (string_view left, char const *right) BOOST_NOEXCEPT
+	{
+		return left == string_view(right, std::strlen(right));
+	}
+
+	inline bool operator != (string_view left, char const *right) BOOST_NOEXCEPT
+	{
+		return !(left == right);
+	}
+
+	inline std::ostream &operator << (std::ostream &out, string_view value)
+	{
+		return out.write(value.data(), static_cast<std::streamsize>(value.size()));
+	}
+
+	inline void push(lua_State &L, string_view value) BOOST_NOEXCEPT
+	{
+		lua_pushlstring(&L, value.data(), value.size());
+	}
+
+	///Like to_string, a number on the stack is converted into a string in place.
+	inline string_view to_string_view(any_local const &local)
+	{
+		std::size_t size = 0;
+		char const * const data = lua_tolstring(local.thread(), local.from_bottom(), &size);
+		if (!data)
+		{
+			return string_view();
+		}
+		return string_view(data, size);
+	}
+
+	inline boost::optional<string_view> get_string_view(any_local const &local)
+	{
+		type const t = get_type(local);
+		if (t != type::string)
+		{
+			return boost::none;
+		}
+		return to_string_view(local);
+	}
+
+	template <>
+	struct from_lua<string_view>
+	{
+		static type const lua_type = type::string;
+
+		string_view operator()(lua_State &L, int address) const
+		{
+			return to_string_view(any_local(L, address));
+		}
+	};
+
+	///A string_view that keeps its string alive with a registry reference, so it can outlive the stack frame.
+	struct pinned_string_view
+	{
+		pinned_string_view() BOOST_NOEXCEPT
+		{
+		}
+
+		pinned_string_view(reference anchor, string_view view) BOOST_NOEXCEPT
+			: m_anchor(std::move(anchor))
+			, m_view(view)
+		{
+		}
+
+		pinned_string_view(pinned_string_view &&other) BOOST_NOEXCEPT
+			: m_anchor(std::move(other.m_anchor))
+			, m_view(other.m_view)
+		{
+		}
+
+		pinned_string_view &operator = (pinned_string_view &&other) BOOST_NOEXCEPT
+		{
+			m_anchor = std::move(other.m_anchor);
+			m_view = other.m_view;
+			return *this;
+		}
+
+		string_view const &view() const BOOST_NOEXCEPT
+		{
+			return m_view;
+		}
+
+		reference const &anchor() const BOOST_NOEXCEPT
+		{
+			return m_anchor;
+		}
+
+	private:
+
+		reference m_anchor;
+		string_view m_view;
+
+		SILICIUM_DELETED_FUNCTION(pinned_string_view(pinned_string_view const &))
+		SILICIUM_DELETED_FUNCTION(pinned_string_view &operator = (pinned_string_view const &))
+	};
+
+	inline pinned_string_view pin_string_view(main_thread thread, any_local const &local)
+	{
+		//the conversion has to happen first because it may replace a number with a string
+		string_view const view = to_string_view(local);
+		return pinned_string_view(create_reference(thread, local), view);
+	}
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef LUACPP_STRUCT_HPP
+#define LUACPP_STRUCT_HPP
+
+#include "luacpp/from_lua_cast.hpp"
+#include <boost/preprocessor/seq/enum.hpp>
+#include <boost/preprocessor/seq/for_each_i.hpp>
+#include <boost/preprocessor/seq/size.hpp>
+#include <boost/preprocessor/seq/transform.hpp>
+#include <boost/preprocessor/stringize.hpp>
+
+namespace lua
+{
+	namespace detail
+	{
+		template <class Struct>
+		void *struct_keys_registry_key() BOOST_NOEXCEPT
+		{
+			static char const key = 0;
+			return const_cast<char *>(&key);
+		}
+
+		///Pushes the table with the field names of the struct. The names are interned once per state and kept in
+		///the registry, so pushing a key later is a lua_rawgeti. Returns the absolute index of the table.
+		template <class Struct>
+		int push_struct_keys(lua_State &L)
+		{
+			typedef struct_description<Struct> description;
+			lua_pushlightuserdata(&L, struct_keys_registry_key<Struct>());
+			lua_rawget(&L, LUA_REGISTRYINDEX);
+			if (lua_istable(&L, -1))
+			{
+				return lua_gettop(&L);
+			}
+			lua_pop(&L, 1);
+			lua_createtable(&L, description::field_count, 0);
+			char const * const * const names = description::field_names();
+			for (int i = 0; i < description::field_count; ++i)
+			{
+				lua_pushstring(&L, names[i]);
+				lua_rawseti(&L, -2, i + 1);
+			}
+			lua_pushlightuserdata(&L, struct_keys_registry_key<Struct>());
+			lua_pushvalue(&L, -2);
+			lua_rawset(&L, LUA_REGISTRYINDEX);
+			return lua_gettop(&L);
+		}
+
+		template <class Field>
+		void push_struct_field(lua_State &L, int table, int keys, int field_number, Field const &value)
+		{
+			using lua::push;
+			lua_rawgeti(&L, keys, field_number);
+			push(L, value);
+			lua_rawset(&L, table);
+		}
+
+		template <class Field>
+		void read_struct_field(lua_State &L, int table, int keys, int field_number, Field &value)
+		{
+			lua_rawgeti(&L, keys, field_number);
+			lua_rawget(&L, table);
+			stack_value field(L, lua_gettop(&L));
+			if (!lua_isnil(&L, field.from_bottom()))
+			{
+				value = from_lua<Field>()(L, field.from_bottom());
+			}
+		}
+
+		template <class Struct>
+		struct struct_from_lua
+		{
+			static type const lua_type = type::table;
+
+			///Missing fields keep the value they have in a value-initialized Struct. Metamethods are not used.
+			Struct operator()(lua_State &L, int address) const
+			{
+				int const table = absolute_index(L, address);
+				Struct result = Struct();
+				//lua_istable would find the member lua_type
+				if (::lua_type(&L, table) != LUA_TTABLE)
+				{
+					return result;
+				}
+				stack_value keys(L, push_struct_keys<Struct>(L));
+				struct_description<Struct>::read(L, table, keys.from_bottom(), result);
+				return result;
+			}
+		};
+	}
+}
+
+#define LUA_CPP_DETAIL_STRINGIZE_FIELD(s, data, field) BOOST_PP_STRINGIZE(field)
+#define LUA_CPP_DETAIL_PUSH_FIELD(r, data, i, field) ::lua::detail::push_struct_field(L, table, keys, (i) + 1, value.field);
+#define LUA_CPP_DETAIL_READ_FIELD(r, data, i, field) ::lua::detail::read_struct_field(L, table, keys, (i) + 1, value.field);
+
+///Makes a struct convertible to and from a Lua table with the given fields, for example
+///LUA_CPP_STRUCT(point, (x)(y)). The table is created with room for exactly these fields and the field names are
+///interned once per state. Has to be used in the global namespace with the fully qualified name of the struct.
+#define LUA_CPP_STRUCT(struct_type, fields) \
+	namespace lua \
+	{ \
+		template <> \
+		struct struct_description<struct_type> \
+		{ \
+			static int const field_count = BOOST_PP_SEQ_SIZE(fields); \
+			\
+			static char const * const *field_names() BOOST_NOEXCEPT \
+			{ \
+				static char const * const names[] = {BOOST_PP_SEQ_ENUM(BOOST_PP_SEQ_TRANSFORM(LUA_CPP_DETAIL_STRINGIZE_FIELD, _, fields))}; \
+				return names; \
+			} \
+			\
+			static void push(lua_State &L, struct_type const &value) \
+			{ \
+				lua_createtable(&L, 0, field_count); \
+				int const table = lua_gettop(&L); \
+				int const keys = ::lua::detail::push_struct_keys<struct_type>(L); \
+				BOOST_PP_SEQ_FOR_EACH_I(LUA_CPP_DETAIL_PUSH_FIELD, _, fields) \
+				lua_pop(&L, 1); \
+			} \
+			\
+			static void read(lua_State &L, int table, int keys, struct_type &value) \
+			{ \
+				BOOST_PP_SEQ_FOR_EACH_I(LUA_CPP_DETAIL_READ_FIELD, _, fields) \
+			} \
+		}; \
+		\
+		template <> \
+		struct from_lua<struct_type> : ::lua::detail::struct_from_lua<struct_type> \
+		{ \
+		}; \
+	}
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef LUACPP_TYPE_REGISTRY_HPP
+#define LUACPP_TYPE_REGISTRY_HPP
+
+#include "luacpp/stack.hpp"
+#include <memory>
+
+namespace lua
+{
+	///A unique address for every type. It is used as a light user data key in the registry.
+	template <class T>
+	void *type_key() BOOST_NOEXCEPT
+	{
+		static char const key = 0;
+		return const_cast<char *>(&key);
+	}
+
+	///Pushes the value that the registry has for the key, nil if there is none.
+	inline void push_registered(lua_State &L, void *key) BOOST_NOEXCEPT
+	{
+		lua_pushlightuserdata(&L, key);
+		lua_rawget(&L, LUA_REGISTRYINDEX);
+	}
+
+	///Returns the meta table that is registered for the key. If there is none yet, a new table is passed to initialize
+	///and registered afterwards, so initialize runs at most once per state and key. Nothing is registered if it throws.
+	template <class Initializer>
+	stack_value get_or_create_meta_table(lua_State &L, void *key, Initializer &&initialize)
+	{
+		push_registered(L, key);
+		if (::lua_type(&L, -1) == LUA_TTABLE)
+		{
+			return stack_value(L, lua_gettop(&L));
+		}
+		lua_pop(&L, 1);
+		stack_value meta = create_table(L);
+		std::forward<Initializer>(initialize)(meta);
+		lua_pushlightuserdata(&L, key);
+		lua_pushvalue(&L, meta.from_bottom());
+		lua_rawset(&L, LUA_REGISTRYINDEX);
+		return meta;
+	}
+
+	namespace detail
+	{
+		///the user data created by push_shared
+		template <class T>
+		struct shared_box
+		{
+			std::shared_ptr<T> object;
+
+			///memory owned by the object outside of the Lua heap, counted until the box is collected
+			std::size_t external_size;
+		};
+
+		///the user data created by push_borrowed
+		template <class T>
+		struct borrowed_box
+		{
+			T *object;
+		};
+
+		///compares the meta table on top of the stack with the one registered for the key
+		inline bool is_registered_meta_table(lua_State &L, void *key) BOOST_NOEXCEPT
+		{
+			push_registered(L, key);
+			bool const is_equal = (lua_rawequal(&L, -1, -2) != 0);
+			lua_pop(&L, 1);
+			return is_equal;
+		}
+	}
+
+	///Returns the object if the value is a full user data with the meta table registered for T, otherwise nullptr.
+	///Objects created with emplace_object, push_shared and push_borrowed are all found. The check compares the meta
+	///table with the registry entry for type_key<T>() without hashing a string.
+	///Nothing is accepted as a T before a meta table is registered for T in this state. assume_type skips the check
+	///for objects that are known to be of type T.
+	template <class T>
+	T *to_object(lua_State &L, int address) BOOST_NOEXCEPT
+	{
+		if (::lua_type(&L, address) != LUA_TUSERDATA)
+		{
+			return nullptr;
+		}
+		void * const data = lua_touserdata(&L, address);
+		if (lua_getmetatable(&L, address))
+		{
+			T *found = nullptr;
+			if (detail::is_registered_meta_table(L, type_key<T>()))
+			{
+				found = static_cast<T *>(data);
+			}
+			else if (detail::is_registered_meta_table(L, type_key<detail::shared_box<T>>()))
+			{
+				found = static_cast<detail::shared_box<T> *>(data)->object.get();
+			}
+			else if (detail::is_registered_meta_table(L, type_key<detail::borrowed_box<T>>()))
+			{
+				found = static_cast<detail::borrowed_box<T> *>(data)->object;
+			}
+			lua_pop(&L, 1);
+			return found;
+		}
+		return nullptr;
+	}
+}
+
+#endif
@@ -0,0 +1,72 @@
+#include <boost/test/unit_test.hpp>
+#include "luacpp/accounting_allocator.hpp"
+#include "luacpp/pool_allocator.hpp"
+#include "luacpp/stack.hpp"
+#include "luacpp/load.hpp"
+#include <numeric>
+
+BOOST_AUTO_TEST_CASE(accounting_allocator_statistics)
+{
+	lua::accounting_allocator<> allocator;
+	{
+		auto state = lua::create_lua(allocator);
+		lua::stack s(*state);
+		lua::stack_value compiled = lua::load_buffer(*state, Si::make_c_str_range(
+			"local t = {}\n"
+			"for i = 1, 100 do\n"
+			"    t[i] = \"element\" .. i\n"
+			"end\n"
+			"return t\n"
+			), "test").value();
+		lua::stack_value result = s.call(compiled, lua::no_arguments(), lua::one());
+		BOOST_CHECK_EQUAL(lua::type::table, result.get_type());
+
+		lua::memory_statistics const &statistics = allocator.statistics();
+		BOOST_CHECK_GT(statistics.live_bytes, 0u);
+		BOOST_CHECK_GE(statistics.peak_bytes, statistics.live_bytes);
+		BOOST_CHECK_GT(statistics.allocation_count, 100u);
+		BOOST_CHECK_EQUAL(statistics.allocation_count, std::accumulate(statistics.size_histogram.begin(), statistics.size_histogram.end(), static_cast<std::size_t>(0)));
+	}
+	BOOST_CHECK_EQUAL(0u, allocator.statistics().live_bytes);
+}
+
+BOOST_AUTO_TEST_CASE(accounting_allocator_histogram_buckets)
+{
+	BOOST_CHECK_EQUAL(0u, lua::memory_statistics::bucket(1));
+	BOOST_CHECK_EQUAL(1u, lua::memory_statistics::bucket(2));
+	BOOST_CHECK_EQUAL(2u, lua::memory_statistics::bucket(3));
+	BOOST_CHECK_EQUAL(2u, lua::memory_statistics::bucket(4));
+	BOOST_CHECK_EQUAL(3u, lua::memory_statistics::bucket(5));
+	BOOST_CHECK_EQUAL(lua::memory_statistics::bucket_count - 1, lua::memory_statistics::bucket(static_cast<std::size_t>(1) << 30));
+}
+
+BOOST_AUTO_TEST_CASE(accounting_allocator_limit_raises_memory_error)
+{
+	std::size_t const limit = 256 * 1024;
+	lua::accounting_allocator<lua::pool_allocator> allocator(limit);
+	auto state = lua::create_lua(allocator);
+	lua::stack s(*state);
+	lua::stack_value compiled = lua::load_buffer(*state, Si::make_c_str_range(
+		"local t = {}\n"
+		"local i = 1\n"
+		"while true do\n"
+		"    t[i] = \"a string that will never be collected \" .. i\n"
+		"    i = i + 1\n"
+		"end\n"
+		), "test").value();
+	try
+	{
+		s.call(compiled, lua::no_arguments(), 0);
+		BOOST_FAIL("an exception was expected");
+	}
+	catch (lua::lua_exception const &ex)
+	{
+		BOOST_CHECK_EQUAL(static_cast<int>(lua::error::mem), ex.code());
+	}
+	BOOST_CHECK_LE(allocator.statistics().peak_bytes, limit);
+
+	//the state is still usable after the error
+	lua::stack_value small = lua::load_buffer(*state, Si::make_c_str_range("return 3"), "test").value();
+	lua::stack_value result = s.call(small, lua::no_arguments(), lua::one());
+	BOOST_CHECK_EQUAL(boost::make_optional<lua_Integer>(3), get_integer(result));
+}
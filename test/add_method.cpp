@@ -154,3 +154,35 @@ BOOST_AUTO_TEST_CASE(lua_wrapper_add_method_const_this_by_pointer)
 		});
 	});
 }
+
+namespace
+{
+	struct other_struct
+	{
+		long value;
+	};
+}
+
+BOOST_AUTO_TEST_CASE(lua_wrapper_add_method_rejects_other_user_data)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value meta = lua::create_default_meta_table<test_struct>(s);
+		lua::add_method(s, meta, "method", &test_struct::method_const);
+		lua::stack_value method = meta["method"];
+		lua::stack_value other_meta = lua::create_default_meta_table<other_struct>(s);
+		other_struct const other = {0};
+		lua::stack_value wrong_object = lua::emplace_object<other_struct>(s, other_meta, other);
+		for (lua::any_local const &argument : {lua::any_local(wrong_object), lua::any_local(meta)})
+		{
+			lua::push(*s.state(), method);
+			lua::push(*s.state(), argument);
+			int const rc = lua_pcall(s.state(), 1, 0, 0);
+			BOOST_CHECK_EQUAL(LUA_ERRRUN, rc);
+			lua::stack_value error(*s.state(), lua_gettop(s.state()));
+			boost::optional<Si::noexcept_string> const message = lua::get_string(error);
+			BOOST_REQUIRE(message);
+			BOOST_CHECK_NE(std::string::npos, std::string(message->c_str()).find("bad argument #1"));
+		}
+	});
+}
@@ -0,0 +1,78 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "luacpp/from_lua_cast.hpp"
+#include "luacpp/load.hpp"
+
+BOOST_AUTO_TEST_CASE(array_conversion_push_vector)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		std::vector<lua_Number> const original = {1.5, 2.5, 3.5};
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range(
+			"local t = ...\n"
+			"return (#t == 3) and (t[1] == 1.5) and (t[2] == 2.5) and (t[3] == 3.5)\n"
+			), "test").value();
+		std::array<std::vector<lua_Number>, 1> const arguments = {{original}};
+		lua::stack_value result = s.call(compiled, Si::make_container_source(arguments), lua::one());
+		BOOST_CHECK_EQUAL(boost::make_optional(true), get_boolean(result));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(array_conversion_round_trip)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		std::vector<lua_Integer> original(10000);
+		for (std::size_t i = 0; i < original.size(); ++i)
+		{
+			original[i] = static_cast<lua_Integer>(i * 3);
+		}
+		lua::push(*s.state(), original);
+		lua::stack_value table(*s.state(), lua_gettop(s.state()));
+		BOOST_CHECK(original == lua::from_lua_cast<std::vector<lua_Integer>>(table));
+
+		std::array<lua_Integer, 3> const prefix = lua::from_lua_cast<std::array<lua_Integer, 3>>(table);
+		BOOST_CHECK_EQUAL(0, prefix[0]);
+		BOOST_CHECK_EQUAL(3, prefix[1]);
+		BOOST_CHECK_EQUAL(6, prefix[2]);
+	});
+}
+
+BOOST_AUTO_TEST_CASE(array_conversion_nested_and_strings)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		std::vector<std::array<Si::noexcept_string, 2>> const original =
+		{
+			{{Si::noexcept_string("a"), Si::noexcept_string("b")}},
+			{{Si::noexcept_string("c"), Si::noexcept_string("d")}}
+		};
+		lua::push(*s.state(), original);
+		lua::stack_value table(*s.state(), lua_gettop(s.state()));
+		BOOST_CHECK(original == (lua::from_lua_cast<std::vector<std::array<Si::noexcept_string, 2>>>(table)));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(array_conversion_short_table)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range("return {1, 2}"), "test").value();
+		lua::stack_value table = s.call(compiled, lua::no_arguments(), lua::one());
+		std::array<lua_Integer, 4> const converted = lua::from_lua_cast<std::array<lua_Integer, 4>>(table);
+		BOOST_CHECK_EQUAL(1, converted[0]);
+		BOOST_CHECK_EQUAL(2, converted[1]);
+		BOOST_CHECK_EQUAL(0, converted[2]);
+		BOOST_CHECK_EQUAL(0, converted[3]);
+	});
+}
+
+BOOST_AUTO_TEST_CASE(array_conversion_not_a_table)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua_pushinteger(s.state(), 3);
+		lua::stack_value number(*s.state(), lua_gettop(s.state()));
+		BOOST_CHECK(lua::from_lua_cast<std::vector<lua_Number>>(number).empty());
+	});
+}
@@ -0,0 +1,126 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "luacpp/box.hpp"
+#include "luacpp/class_builder.hpp"
+#include "luacpp/load.hpp"
+
+namespace
+{
+	struct session
+	{
+		lua_Integer requests;
+
+		void handle_request()
+		{
+			++requests;
+		}
+	};
+
+	lua::stack_value create_session_meta_table(lua::stack &s)
+	{
+		return lua::create_default_meta_table<session>(s, [&s](lua::stack_value &meta)
+		{
+			lua::class_builder<session>()
+				.read_only("requests", &session::requests)
+				.method("handle_request", &session::handle_request)
+				.apply(s, meta);
+		});
+	}
+
+	lua_Integer handle_twice(lua::stack &s, lua::stack_value const &object)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range(
+			"local session = ... session:handle_request() session:handle_request() return session.requests"
+			), "test").value();
+		return std::get<0>(s.call<lua_Integer>(compiled, object));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(lua_push_shared)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		create_session_meta_table(s).pop();
+		auto const original = std::make_shared<session>();
+		original->requests = 1;
+		{
+			lua::stack_value object = lua::push_shared(s, original);
+			BOOST_CHECK_EQUAL(2, original.use_count());
+			BOOST_CHECK_EQUAL(original.get(), lua::to_object<session>(*s.state(), object.from_bottom()));
+			BOOST_CHECK_EQUAL(3, handle_twice(s, object));
+			BOOST_CHECK_EQUAL(3, original->requests);
+		}
+		lua_gc(s.state(), LUA_GCCOLLECT, 0);
+		BOOST_CHECK_EQUAL(1, original.use_count());
+	});
+}
+
+namespace
+{
+	struct counted_object
+	{
+		explicit counted_object(std::size_t &destroyed)
+			: destroyed(&destroyed)
+		{
+		}
+
+		~counted_object()
+		{
+			++*destroyed;
+		}
+
+		std::size_t *destroyed;
+	};
+
+	///pushes boxes that are garbage right away and returns how many of the objects were destroyed in the meantime
+	std::size_t count_collected_while_pushing(std::size_t external_size)
+	{
+		std::size_t destroyed = 0;
+		auto state = lua::create_lua();
+		lua::stack s(*state);
+		for (int i = 0; i < 100; ++i)
+		{
+			lua::push_shared(s, std::make_shared<counted_object>(destroyed), external_size).pop();
+		}
+		return destroyed;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(lua_push_shared_reports_external_memory)
+{
+	//the boxes are small, so the collector would not run for them alone
+	std::size_t const unaccounted = count_collected_while_pushing(0);
+	std::size_t const accounted = count_collected_while_pushing(1024 * 1024);
+	BOOST_CHECK_GE(accounted, 50u);
+	BOOST_CHECK_LT(unaccounted, accounted);
+}
+
+BOOST_AUTO_TEST_CASE(lua_push_borrowed)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		create_session_meta_table(s).pop();
+		session original = {5};
+		lua::stack_value object = lua::push_borrowed(s, original);
+		BOOST_CHECK_EQUAL(&original, lua::to_object<session>(*s.state(), object.from_bottom()));
+		BOOST_CHECK_EQUAL(7, handle_twice(s, object));
+		BOOST_CHECK_EQUAL(7, original.requests);
+		BOOST_REQUIRE(lua_getmetatable(s.state(), object.from_bottom()));
+		lua::stack_value meta(*s.state(), lua_gettop(s.state()));
+		lua::stack_value gc = meta["__gc"];
+		BOOST_CHECK_EQUAL(lua::type::nil, lua::get_type(gc));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_to_object_rejects_boxes_of_other_types)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		create_session_meta_table(s).pop();
+		lua::create_default_meta_table<long>(s).pop();
+		long number = 0;
+		lua::stack_value object = lua::push_borrowed(s, number);
+		BOOST_CHECK(!lua::to_object<session>(*s.state(), object.from_bottom()));
+		BOOST_CHECK_EQUAL(&number, lua::to_object<long>(*s.state(), object.from_bottom()));
+	});
+}
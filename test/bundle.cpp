@@ -0,0 +1,56 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "temporary_directory.hpp"
+#include "luacpp/bundle.hpp"
+#include <boost/lexical_cast.hpp>
+
+namespace
+{
+	lua_Integer call_chunk(lua::stack &s, lua::bundle_file const &bundle, std::string const &name)
+	{
+		lua::stack_value compiled = lua::load_from_bundle(*s.state(), bundle, name).value();
+		lua::stack_value result = s.call(compiled, lua::no_arguments(), lua::one());
+		return lua::to_integer(result);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(bundle_compile_write_load)
+{
+	test::temporary_directory directory;
+	boost::filesystem::path const scripts = directory.path / "scripts";
+	boost::filesystem::create_directories(scripts / "nested");
+	for (int i = 0; i < 20; ++i)
+	{
+		std::string const number = boost::lexical_cast<std::string>(i);
+		test::write_file(scripts / ("script" + number + ".lua"), "return " + number);
+	}
+	test::write_file(scripts / "nested" / "deep.lua", "return 100");
+	test::write_file(scripts / "not_a_script.txt", "return (");
+
+	lua::bytecode_bundle const compiled = lua::compile_directory(scripts, 4);
+	BOOST_REQUIRE_EQUAL(21u, compiled.size());
+	boost::filesystem::path const bundle_path = directory.path / "scripts.bundle";
+	lua::write_bundle(bundle_path, compiled);
+
+	//the bundle does not depend on the original files anymore
+	boost::filesystem::remove_all(scripts);
+
+	lua::bundle_file const bundle(bundle_path);
+	BOOST_CHECK_EQUAL(21u, bundle.size());
+	test::test_with_environment([&bundle](lua::stack &s, test::resource)
+	{
+		BOOST_CHECK_EQUAL(0, call_chunk(s, bundle, "script0.lua"));
+		BOOST_CHECK_EQUAL(19, call_chunk(s, bundle, "script19.lua"));
+		BOOST_CHECK_EQUAL(100, call_chunk(s, bundle, "nested/deep.lua"));
+		lua::result missing = lua::load_from_bundle(*s.state(), bundle, "missing.lua");
+		BOOST_CHECK_EQUAL(static_cast<int>(lua::error::file), missing.code());
+	});
+}
+
+BOOST_AUTO_TEST_CASE(bundle_compile_error)
+{
+	test::temporary_directory directory;
+	test::write_file(directory.path / "fine.lua", "return 1");
+	test::write_file(directory.path / "broken.lua", "return (");
+	BOOST_CHECK_THROW(lua::compile_directory(directory.path, 2), lua::lua_exception);
+}
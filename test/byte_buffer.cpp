@@ -0,0 +1,70 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "luacpp/byte_buffer.hpp"
+#include "luacpp/from_lua_cast.hpp"
+#include "luacpp/load.hpp"
+
+BOOST_AUTO_TEST_CASE(byte_buffer_methods)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		std::string const content = "hello world";
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range(
+			"local b = ...\n"
+			"return b:len(), #b, b:sub(7):tostring(), b:byte(1), b:sub(-5, -2):len(), b:sub(20):len()\n"
+			), "test").value();
+		std::array<lua::byte_buffer, 1> const arguments = {{lua::make_byte_buffer(std::vector<char>(content.begin(), content.end()))}};
+		lua::stack_array results = s.call(compiled, Si::make_container_source(arguments), 6);
+		BOOST_CHECK_EQUAL(boost::make_optional<lua_Integer>(11), get_integer(at(results, 0)));
+		BOOST_CHECK_EQUAL(boost::make_optional<lua_Integer>(11), get_integer(at(results, 1)));
+		BOOST_CHECK_EQUAL(boost::make_optional(Si::noexcept_string("world")), get_string(at(results, 2)));
+		BOOST_CHECK_EQUAL(boost::make_optional<lua_Integer>('h'), get_integer(at(results, 3)));
+		BOOST_CHECK_EQUAL(boost::make_optional<lua_Integer>(4), get_integer(at(results, 4)));
+		BOOST_CHECK_EQUAL(boost::make_optional<lua_Integer>(0), get_integer(at(results, 5)));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(byte_buffer_from_lua_does_not_copy)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		static char const content[] = "abc";
+		Si::memory_range const original = Si::make_memory_range(content, content + 3);
+		lua::push(*s.state(), lua::byte_buffer(original, nullptr));
+		lua::stack_value buffer(*s.state(), lua_gettop(s.state()));
+		Si::memory_range const converted = lua::from_lua_cast<Si::memory_range>(buffer);
+		BOOST_CHECK_EQUAL(original.begin(), converted.begin());
+		BOOST_CHECK_EQUAL(original.end(), converted.end());
+	});
+}
+
+BOOST_AUTO_TEST_CASE(byte_buffer_sub_keeps_owner_alive)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::byte_buffer original = lua::make_byte_buffer(std::vector<char>(100, 'a'));
+		std::weak_ptr<void const> const owner = original.owner;
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range("local b = ... return b:sub(10, 19)"), "test").value();
+		std::array<lua::byte_buffer, 1> const arguments = {{std::move(original)}};
+		lua::stack_value sub = s.call(compiled, Si::make_container_source(arguments), lua::one());
+		original = lua::byte_buffer();
+		BOOST_CHECK_EQUAL(10, lua::from_lua_cast<Si::memory_range>(sub).size());
+		lua_gc(s.state(), LUA_GCCOLLECT, 0);
+		BOOST_CHECK(!owner.expired());
+	});
+}
+
+BOOST_AUTO_TEST_CASE(byte_buffer_collected)
+{
+	auto state = lua::create_lua();
+	std::weak_ptr<void const> owner;
+	{
+		lua::byte_buffer buffer = lua::make_byte_buffer(std::vector<char>(100, 'a'));
+		owner = buffer.owner;
+		lua::push(*state, buffer);
+		lua_pop(state.get(), 1);
+	}
+	BOOST_CHECK(!owner.expired());
+	lua_gc(state.get(), LUA_GCCOLLECT, 0);
+	BOOST_CHECK(owner.expired());
+}
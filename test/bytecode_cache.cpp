@@ -0,0 +1,98 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "temporary_directory.hpp"
+#include "luacpp/bytecode_cache.hpp"
+
+namespace
+{
+	lua_Integer load_and_call(lua::stack &s, boost::filesystem::path const &script, lua::file_bytecode_cache &cache)
+	{
+		lua::stack_value compiled = lua::load_file(*s.state(), script, cache).value();
+		lua::stack_value result = s.call(compiled, lua::no_arguments(), lua::one());
+		return lua::to_integer(result);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(file_bytecode_cache_hit_and_change)
+{
+	test::temporary_directory directory;
+	boost::filesystem::path const script = directory.path / "script.lua";
+	test::write_file(script, "#!/usr/bin/lua\nreturn 1 + 2\n");
+	lua::file_bytecode_cache cache(directory.path / "cache");
+	test::test_with_environment([&](lua::stack &s, test::resource)
+	{
+		BOOST_CHECK_EQUAL(3, load_and_call(s, script, cache));
+		BOOST_REQUIRE(boost::filesystem::exists(cache.entry_path(script)));
+		BOOST_CHECK_EQUAL(3, load_and_call(s, script, cache));
+
+		//the modification time may stay the same, but the content hash changes
+		test::write_file(script, "return 4 + 5\n");
+		BOOST_CHECK_EQUAL(9, load_and_call(s, script, cache));
+		BOOST_CHECK_EQUAL(9, load_and_call(s, script, cache));
+
+		cache.invalidate(script);
+		BOOST_CHECK(!boost::filesystem::exists(cache.entry_path(script)));
+		BOOST_CHECK_EQUAL(9, load_and_call(s, script, cache));
+		BOOST_CHECK(boost::filesystem::exists(cache.entry_path(script)));
+
+		cache.clear();
+		BOOST_CHECK(!boost::filesystem::exists(cache.entry_path(script)));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(file_bytecode_cache_disabled)
+{
+	test::temporary_directory directory;
+	boost::filesystem::path const script = directory.path / "script.lua";
+	test::write_file(script, "return 5");
+	lua::file_bytecode_cache cache(directory.path / "cache", false);
+	test::test_with_environment([&](lua::stack &s, test::resource)
+	{
+		BOOST_CHECK_EQUAL(5, load_and_call(s, script, cache));
+		BOOST_CHECK(!boost::filesystem::exists(cache.entry_path(script)));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(file_bytecode_cache_errors)
+{
+	test::temporary_directory directory;
+	lua::file_bytecode_cache cache(directory.path / "cache");
+	test::test_with_environment([&](lua::stack &s, test::resource)
+	{
+		{
+			lua::result missing = lua::load_file(*s.state(), directory.path / "missing.lua", cache);
+			BOOST_CHECK_EQUAL(static_cast<int>(lua::error::file), missing.code());
+		}
+		boost::filesystem::path const script = directory.path / "syntax_error.lua";
+		test::write_file(script, "return (");
+		{
+			lua::result broken = lua::load_file(*s.state(), script, cache);
+			BOOST_CHECK_EQUAL(static_cast<int>(lua::error::syntax), broken.code());
+		}
+		BOOST_CHECK(!boost::filesystem::exists(cache.entry_path(script)));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(memory_bytecode_cache_across_states)
+{
+	lua::memory_bytecode_cache cache;
+	for (int i = 0; i < 3; ++i)
+	{
+		test::test_with_environment([&cache](lua::stack &s, test::resource)
+		{
+			lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range("return 6 * 7"), "test", cache).value();
+			lua::stack_value result = s.call(compiled, lua::no_arguments(), lua::one());
+			BOOST_CHECK_EQUAL(42, lua::to_integer(result));
+		});
+		BOOST_CHECK_EQUAL(1u, cache.size());
+	}
+	test::test_with_environment([&cache](lua::stack &s, test::resource)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range("return 6 * 8"), "test", cache).value();
+		lua::stack_value result = s.call(compiled, lua::no_arguments(), lua::one());
+		BOOST_CHECK_EQUAL(48, lua::to_integer(result));
+	});
+	BOOST_CHECK_EQUAL(1u, cache.size());
+	cache.invalidate("test");
+	BOOST_CHECK_EQUAL(0u, cache.size());
+}
@@ -0,0 +1,46 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "luacpp/from_lua_cast.hpp"
+#include "luacpp/load.hpp"
+#include <silicium/sink/iterator_sink.hpp>
+
+BOOST_AUTO_TEST_CASE(call_many_results)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range("return function (a, b) return a * b end"), "test").value();
+		lua::stack_value multiply = s.call(compiled, lua::no_arguments(), lua::one());
+		std::vector<std::tuple<lua_Integer, lua_Number>> const arguments =
+		{
+			std::make_tuple(1, 2.5),
+			std::make_tuple(2, 3.0),
+			std::make_tuple(-4, 0.5)
+		};
+		std::vector<lua_Number> products;
+		std::size_t const calls = s.call_many<lua_Number>(multiply, Si::make_container_source(arguments), Si::make_container_sink(products));
+		BOOST_CHECK_EQUAL(3u, calls);
+		std::vector<lua_Number> const expected = {2.5, 6.0, -2.0};
+		BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), products.begin(), products.end());
+	});
+}
+
+BOOST_AUTO_TEST_CASE(call_many_error)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range(
+			"return function (a) if a == 2 then error('two') end return a end"
+			), "test").value();
+		lua::stack_value identity = s.call(compiled, lua::no_arguments(), lua::one());
+		std::vector<std::tuple<lua_Integer>> const arguments =
+		{
+			std::make_tuple(1),
+			std::make_tuple(2),
+			std::make_tuple(3)
+		};
+		std::vector<lua_Integer> results;
+		BOOST_CHECK_THROW(s.call_many<lua_Integer>(identity, Si::make_container_source(arguments), Si::make_container_sink(results)), lua::lua_exception);
+		BOOST_REQUIRE_EQUAL(1u, results.size());
+		BOOST_CHECK_EQUAL(1, results[0]);
+	});
+}
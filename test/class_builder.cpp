@@ -0,0 +1,157 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "luacpp/class_builder.hpp"
+#include "luacpp/load.hpp"
+
+namespace
+{
+	struct point
+	{
+		lua_Number x;
+		lua_Number y;
+		lua_Integer id;
+
+		lua_Number sum() const
+		{
+			return x + y;
+		}
+
+		void move(lua_Number dx, lua_Number dy)
+		{
+			x += dx;
+			y += dy;
+		}
+	};
+
+	lua::class_builder<point> describe_point()
+	{
+		lua::class_builder<point> builder;
+		builder
+			.property("x", &point::x)
+			.property("y", &point::y)
+			.read_only("id", &point::id)
+			.method("sum", &point::sum)
+			.method("move", &point::move)
+			.method("scaled_x", [](point const &p, lua_Number factor)
+			{
+				return p.x * factor;
+			});
+		return builder;
+	}
+
+	struct strict_number
+	{
+		lua_Number value;
+	};
+
+	void push(lua_State &L, strict_number number) BOOST_NOEXCEPT
+	{
+		lua_pushnumber(&L, number.value);
+	}
+
+	struct measurement
+	{
+		strict_number value;
+	};
+
+	template <class Result>
+	Result run(lua::stack &s, lua::stack_value const &object, char const *code)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range(code), "test").value();
+		return std::get<0>(s.call<Result>(compiled, object));
+	}
+}
+
+namespace lua
+{
+	template <>
+	struct from_lua<strict_number>
+	{
+		strict_number operator()(lua_State &L, int address) const
+		{
+			if (::lua_type(&L, address) != LUA_TNUMBER)
+			{
+				boost::throw_exception(std::invalid_argument("a number was expected"));
+			}
+			return strict_number{lua_tonumber(&L, address)};
+		}
+	};
+}
+
+BOOST_AUTO_TEST_CASE(lua_class_builder_properties_and_methods)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::class_builder<point> const builder = describe_point();
+		lua::stack_value meta = lua::create_default_meta_table<point>(s, [&s, &builder](lua::stack_value &table)
+		{
+			builder.apply(s, table);
+		});
+		point const original = {1, 2, 7};
+		lua::stack_value object = lua::emplace_object<point>(s, meta, original);
+		point &stored = lua::assume_type<point>(object);
+		BOOST_CHECK_EQUAL(721, run<lua_Number>(s, object, "local p = ... return p.x + p.y * 10 + p.id * 100"));
+		BOOST_CHECK_EQUAL(21, run<lua_Number>(s, object, "local p = ... p.x = 5 p:move(1, 1) return p:sum() + p:scaled_x(2)"));
+		BOOST_CHECK_EQUAL(6, stored.x);
+		BOOST_CHECK_EQUAL(3, stored.y);
+		BOOST_CHECK(run<bool>(s, object, "local p = ... return p.unknown == nil and p[1] == nil"));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_class_builder_read_only)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::class_builder<point> const builder = describe_point();
+		lua::stack_value meta = lua::create_default_meta_table<point>(s, [&s, &builder](lua::stack_value &table)
+		{
+			builder.apply(s, table);
+		});
+		point const original = {1, 2, 7};
+		lua::stack_value object = lua::emplace_object<point>(s, meta, original);
+		for (char const *code : {"local p = ... p.id = 8", "local p = ... p.sum = 1", "local p = ... p.unknown = 1"})
+		{
+			BOOST_CHECK_THROW(run<bool>(s, object, code), lua::lua_exception);
+		}
+		BOOST_CHECK_EQUAL(7, lua::assume_type<point>(object).id);
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_class_builder_errors_become_lua_errors)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::class_builder<measurement> builder;
+		builder.property("value", &measurement::value);
+		lua::stack_value meta = lua::create_default_meta_table<measurement>(s, [&s, &builder](lua::stack_value &table)
+		{
+			builder.apply(s, table);
+		});
+		measurement const original = {{3}};
+		lua::stack_value object = lua::emplace_object<measurement>(s, meta, original);
+		BOOST_CHECK_THROW(run<bool>(s, object, "local m = ... m.value = 'not a number'"), lua::lua_exception);
+		BOOST_CHECK_EQUAL(3, lua::assume_type<measurement>(object).value.value);
+		BOOST_CHECK_THROW(run<bool>(s, object, "local m = ... return getmetatable(m).__index({}, 'value')"), lua::lua_exception);
+		BOOST_CHECK_THROW(run<bool>(s, object, "local m = ... getmetatable(m).__newindex({}, 'value', 1)"), lua::lua_exception);
+		BOOST_CHECK_EQUAL(4, run<lua_Number>(s, object, "local m = ... m.value = 4 return m.value"));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_perfect_hash_has_no_collisions)
+{
+	std::vector<char> storage(1000);
+	std::vector<void const *> keys;
+	for (std::size_t i = 0; i < storage.size(); i += 7)
+	{
+		keys.push_back(&storage[i]);
+	}
+	lua::detail::perfect_hash const hash = lua::detail::find_perfect_hash(keys);
+	std::vector<bool> used(hash.size);
+	for (void const *key : keys)
+	{
+		std::size_t const slot = hash(key);
+		BOOST_REQUIRE_LT(slot, used.size());
+		BOOST_CHECK(!used[slot]);
+		used[slot] = true;
+	}
+}
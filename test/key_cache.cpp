@@ -0,0 +1,74 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "luacpp/key_cache.hpp"
+
+BOOST_AUTO_TEST_CASE(key_cache_push)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::key_cache const keys(lua::main_thread(*s.state()), {"first", "second"});
+		BOOST_REQUIRE_EQUAL(2u, keys.size());
+		lua::push(*s.state(), keys[1]);
+		lua::stack_value pushed(*s.state(), lua_gettop(s.state()));
+		BOOST_CHECK_EQUAL(boost::make_optional(Si::noexcept_string("second")), get_string(pushed));
+		BOOST_CHECK_EQUAL(keys[0].registry_key, keys.find("first").registry_key);
+		BOOST_CHECK(keys.find("third").empty());
+	});
+}
+
+BOOST_AUTO_TEST_CASE(key_cache_element_access)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::key_cache keys(lua::main_thread(*s.state()), {"name"});
+		lua::interned_key const name = keys[0];
+		BOOST_CHECK_EQUAL(name.registry_key, keys.intern("name").registry_key);
+		lua::interned_key const value = keys.intern("value");
+		BOOST_CHECK_EQUAL(2u, keys.size());
+
+		lua::stack_value table = lua::create_table(*s.state());
+		lua::set_element(table, name, "abc");
+		lua::set_element(table, value, static_cast<lua_Integer>(3));
+		{
+			lua::stack_value element = lua::get_element(table, "name");
+			BOOST_CHECK_EQUAL(boost::make_optional(Si::noexcept_string("abc")), get_string(element));
+		}
+		{
+			lua::stack_value element = table[value];
+			BOOST_CHECK_EQUAL(boost::make_optional<lua_Integer>(3), get_integer(element));
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(key_cache_may_outlive_the_state)
+{
+	std::unique_ptr<lua::key_cache> keys;
+	{
+		auto state = lua::create_lua();
+		keys.reset(new lua::key_cache(lua::main_thread(*state), {"name"}));
+	}
+	BOOST_CHECK_EQUAL(1u, keys->size());
+	//must not access the closed state
+	keys.reset();
+}
+
+BOOST_AUTO_TEST_CASE(key_cache_shares_the_registry_slots)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		int first_key = LUA_NOREF;
+		{
+			lua::key_cache const first(lua::main_thread(*s.state()), {"name"});
+			first_key = first[0].registry_key;
+		}
+		for (int i = 0; i < 10; ++i)
+		{
+			lua::key_cache const later(lua::main_thread(*s.state()), {"value", "name"});
+			BOOST_CHECK_EQUAL(first_key, later[1].registry_key);
+			BOOST_CHECK_NE(first_key, later[0].registry_key);
+		}
+		lua::key_cache const last(lua::main_thread(*s.state()), {"value"});
+		lua::key_cache const another(lua::main_thread(*s.state()), {"value"});
+		BOOST_CHECK_EQUAL(last[0].registry_key, another[0].registry_key);
+	});
+}
@@ -0,0 +1,81 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "temporary_directory.hpp"
+#include "luacpp/load_mapped_file.hpp"
+#include "luacpp/bytecode_cache.hpp"
+
+namespace
+{
+	boost::optional<lua_Integer> load_and_call(lua::stack &s, boost::filesystem::path const &script)
+	{
+		lua::stack_value compiled = lua::load_mapped_file(*s.state(), script).value();
+		lua::stack_value result = s.call(compiled, lua::no_arguments(), lua::one());
+		return lua::get_integer(result);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(load_mapped_file_source)
+{
+	test::temporary_directory directory;
+	boost::filesystem::path const script = directory.path / "script.lua";
+	test::write_file(script, "local a = 2\nreturn a * 21\n");
+	test::test_with_environment([&script](lua::stack &s, test::resource)
+	{
+		BOOST_CHECK_EQUAL(boost::make_optional<lua_Integer>(42), load_and_call(s, script));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(load_mapped_file_shebang)
+{
+	test::temporary_directory directory;
+	boost::filesystem::path const script = directory.path / "script.lua";
+	test::write_file(script, "#!/usr/bin/env lua\nreturn 3\n");
+	test::test_with_environment([&script](lua::stack &s, test::resource)
+	{
+		BOOST_CHECK_EQUAL(boost::make_optional<lua_Integer>(3), load_and_call(s, script));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(load_mapped_file_empty)
+{
+	test::temporary_directory directory;
+	boost::filesystem::path const script = directory.path / "empty.lua";
+	test::write_file(script, "");
+	test::test_with_environment([&script](lua::stack &s, test::resource)
+	{
+		BOOST_CHECK_EQUAL(boost::none, load_and_call(s, script));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(load_mapped_file_bytecode)
+{
+	test::temporary_directory directory;
+	boost::filesystem::path const compiled_file = directory.path / "script.luac";
+	test::test_with_environment([&compiled_file](lua::stack &s, test::resource)
+	{
+		{
+			lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range("return 7"), "test").value();
+			std::vector<char> const bytecode = lua::dump(*s.state(), compiled);
+			test::write_file(compiled_file, std::string(bytecode.begin(), bytecode.end()));
+		}
+		BOOST_CHECK_EQUAL(boost::make_optional<lua_Integer>(7), load_and_call(s, compiled_file));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(load_mapped_file_errors)
+{
+	test::temporary_directory directory;
+	boost::filesystem::path const broken = directory.path / "broken.lua";
+	test::write_file(broken, "return (");
+	test::test_with_environment([&directory, &broken](lua::stack &s, test::resource)
+	{
+		{
+			lua::result missing = lua::load_mapped_file(*s.state(), directory.path / "missing.lua");
+			BOOST_CHECK_EQUAL(static_cast<int>(lua::error::file), missing.code());
+		}
+		{
+			lua::result syntax_error = lua::load_mapped_file(*s.state(), broken);
+			BOOST_CHECK_EQUAL(static_cast<int>(lua::error::syntax), syntax_error.code());
+		}
+	});
+}
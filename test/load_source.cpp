@@ -0,0 +1,181 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "luacpp/load_source.hpp"
+#include <silicium/source/memory_source.hpp>
+#include <algorithm>
+
+namespace
+{
+	boost::optional<Si::noexcept_string> load_and_call(lua::stack &s, lua::result loaded)
+	{
+		lua::stack_value compiled = std::move(loaded).value();
+		lua::stack_value result = s.call(compiled, lua::no_arguments(), lua::one());
+		return lua::get_string(result);
+	}
+
+	std::string const script =
+		"--[[ a long\n"
+		"comment ]] local text = \"a \\\"quoted\\\" string\" -- short comment\n"
+		"local number = 1e3 + 0x10\n"
+		"return text .. [==[ and a [[long]] string ]==] .. number\n";
+
+	char const * const expected = "a \"quoted\" string and a [[long]] string 1016";
+
+	///Copies at most the next of the given block sizes per call, so a read can end anywhere in a token.
+	///Everything after the last block size is copied one character at a time.
+	struct trickling_source : Si::source<char>
+	{
+		trickling_source(std::string content, std::vector<std::size_t> block_sizes)
+			: m_content(std::move(content))
+			, m_block_sizes(std::move(block_sizes))
+			, m_read(0)
+			, m_blocks_read(0)
+		{
+		}
+
+		virtual Si::iterator_range<char const *> map_next(std::size_t) SILICIUM_OVERRIDE
+		{
+			return Si::iterator_range<char const *>();
+		}
+
+		virtual char *copy_next(Si::iterator_range<char *> destination) SILICIUM_OVERRIDE
+		{
+			std::size_t const block_size = (m_blocks_read < m_block_sizes.size()) ? m_block_sizes[m_blocks_read] : 1;
+			++m_blocks_read;
+			std::size_t const copied = (std::min)({block_size, static_cast<std::size_t>(destination.size()), m_content.size() - m_read});
+			char * const end = std::copy(m_content.begin() + m_read, m_content.begin() + m_read + copied, destination.begin());
+			m_read += copied;
+			return end;
+		}
+
+	private:
+
+		std::string m_content;
+		std::vector<std::size_t> m_block_sizes;
+		std::size_t m_read;
+		std::size_t m_blocks_read;
+	};
+
+	//the string literal contains characters of two, three and four bytes in UTF-8
+	std::string const script_with_shebang =
+		"#!/usr/bin/env lua -- not Lua code\n"
+		"local greeting = \"gr\xC3\xBC\xC3\x9F" "e \xE2\x82\xAC \xF0\x9D\x84\x9E\"\n"
+		"local answer = 6 *\n"
+		"    7\n"
+		"return greeting .. ' ' .. answer\n";
+
+	char const * const expected_with_shebang = "gr\xC3\xBC\xC3\x9F" "e \xE2\x82\xAC \xF0\x9D\x84\x9E 42";
+}
+
+BOOST_AUTO_TEST_CASE(load_source_ranges_split_everywhere)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		for (std::size_t split = 0; split <= script.size(); ++split)
+		{
+			std::vector<Si::memory_range> const chunks
+			{
+				Si::memory_range(),
+				Si::make_memory_range(script.data(), script.data() + split),
+				Si::memory_range(),
+				Si::memory_range(),
+				Si::make_memory_range(script.data() + split, script.data() + script.size()),
+				Si::memory_range()
+			};
+			auto source = Si::make_container_source(chunks);
+			BOOST_CHECK_EQUAL(boost::optional<Si::noexcept_string>(Si::noexcept_string(expected)), load_and_call(s, lua::load_source(*s.state(), source, "test")));
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(load_source_ranges_one_byte_each)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		std::vector<Si::memory_range> chunks;
+		for (char const &c : script)
+		{
+			chunks.emplace_back(Si::make_memory_range(&c, &c + 1));
+			chunks.emplace_back(Si::memory_range());
+		}
+		auto source = Si::make_container_source(chunks);
+		BOOST_CHECK_EQUAL(boost::optional<Si::noexcept_string>(Si::noexcept_string(expected)), load_and_call(s, lua::load_source(*s.state(), source, "test")));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(load_source_chars_bigger_than_the_buffer)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		std::string code = "local t = {}\n";
+		for (int i = 0; i < 1000; ++i)
+		{
+			code += "t[#t + 1] = 'x'\n";
+		}
+		code += "return tostring(#t)\n";
+		std::vector<char> const characters(code.begin(), code.end());
+		auto source = Si::make_container_source(characters);
+		luaopen_base(s.state());
+		lua_settop(s.state(), 0);
+		BOOST_CHECK_EQUAL(boost::optional<Si::noexcept_string>(Si::noexcept_string("1000")), load_and_call(s, lua::load_source(*s.state(), source, "test")));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(load_source_chars_one_at_a_time)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		trickling_source source(script_with_shebang, std::vector<std::size_t>());
+		BOOST_CHECK_EQUAL(boost::optional<Si::noexcept_string>(Si::noexcept_string(expected_with_shebang)), load_and_call(s, lua::load_source(*s.state(), source, "test")));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(load_source_chars_short_read_everywhere)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		//a read of zero characters would end the source, so the first read gets at least one
+		for (std::size_t split = 1; split < script_with_shebang.size(); ++split)
+		{
+			std::vector<std::size_t> const block_sizes{split, 3, script_with_shebang.size()};
+			trickling_source source(script_with_shebang, block_sizes);
+			BOOST_CHECK_EQUAL(boost::optional<Si::noexcept_string>(Si::noexcept_string(expected_with_shebang)), load_and_call(s, lua::load_source(*s.state(), source, "test")));
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(load_source_shebang_keeps_line_numbers)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		std::string const broken = "#!/usr/bin/env lua\nlocal a = 1\nreturn (";
+		trickling_source source(broken, std::vector<std::size_t>{5, 20});
+		lua::result loaded = lua::load_source(*s.state(), source, "=test");
+		BOOST_REQUIRE_EQUAL(static_cast<int>(lua::error::syntax), loaded.code());
+		boost::optional<Si::noexcept_string> const text = lua::get_string(loaded.get_error());
+		BOOST_REQUIRE(text);
+		BOOST_CHECK_NE(std::string::npos, std::string(text->c_str()).find("test:3:"));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(load_source_empty)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		std::vector<Si::memory_range> const chunks;
+		auto source = Si::make_container_source(chunks);
+		BOOST_CHECK_EQUAL(boost::none, load_and_call(s, lua::load_source(*s.state(), source, "test")));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(load_source_syntax_error)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		std::string const broken = "return (";
+		std::vector<char> const characters(broken.begin(), broken.end());
+		auto source = Si::make_container_source(characters);
+		lua::result loaded = lua::load_source(*s.state(), source, "test");
+		BOOST_CHECK_EQUAL(static_cast<int>(lua::error::syntax), loaded.code());
+	});
+}
@@ -349,3 +349,39 @@ BOOST_AUTO_TEST_CASE(lua_wrapper_index_operator)
 		BOOST_CHECK_EQUAL(lua::type::nil, get_type(element_2));
 	});
 }
+
+BOOST_AUTO_TEST_CASE(lua_wrapper_register_any_function_returns_tuple)
+{
+	test::test_with_environment([](lua::stack &s, test::resource bound)
+	{
+		lua::stack_value registered = lua::register_any_function(
+			s,
+			[bound](lua_Integer a, lua_Integer b)
+		{
+			return std::make_tuple(a + b, a * b, Si::noexcept_string("text"));
+		});
+		std::array<lua_Integer, 2> const arguments = {{3, 4}};
+		lua::stack_array results = s.call(registered, Si::make_container_source(arguments), boost::none);
+		BOOST_REQUIRE_EQUAL(3, results.size());
+		BOOST_CHECK_EQUAL(boost::make_optional<lua_Integer>(7), get_integer(at(results, 0)));
+		BOOST_CHECK_EQUAL(boost::make_optional<lua_Integer>(12), get_integer(at(results, 1)));
+		BOOST_CHECK_EQUAL(boost::make_optional(Si::noexcept_string("text")), get_string(at(results, 2)));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_wrapper_register_any_function_returns_pair)
+{
+	test::test_with_environment([](lua::stack &s, test::resource bound)
+	{
+		lua::stack_value registered = lua::register_any_function(
+			s,
+			[bound]()
+		{
+			return std::make_pair(true, static_cast<lua_Number>(1.5));
+		});
+		lua::stack_array results = s.call(registered, lua::no_arguments(), boost::none);
+		BOOST_REQUIRE_EQUAL(2, results.size());
+		BOOST_CHECK_EQUAL(boost::make_optional(true), get_boolean(at(results, 0)));
+		BOOST_CHECK_EQUAL(boost::make_optional<lua_Number>(1.5), get_number(at(results, 1)));
+	});
+}
@@ -53,3 +53,92 @@ BOOST_AUTO_TEST_CASE(lua_pcall_2_arguments)
 		BOOST_CHECK_EQUAL(43 + 2, lua::to_integer(results.element_address(1)));
 	});
 }
+
+BOOST_AUTO_TEST_CASE(lua_pcall_error_with_traceback)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range(
+			"local function inner() error('inner failed') end\n"
+			"function outer() inner() end\n"
+			"outer()\n"
+			), "traceback_test").value();
+		luaopen_base(s.state());
+		lua_settop(s.state(), 1);
+		try
+		{
+			s.call(compiled, lua::no_arguments(), 0);
+			BOOST_FAIL("an exception was expected");
+		}
+		catch (lua::lua_exception const &ex)
+		{
+			std::string const message = ex.what();
+			BOOST_CHECK_EQUAL(LUA_ERRRUN, ex.code());
+			BOOST_CHECK_NE(std::string::npos, message.find("inner failed"));
+			BOOST_CHECK_NE(std::string::npos, message.find("stack traceback:"));
+			BOOST_CHECK_NE(std::string::npos, message.find("in function 'inner'"));
+			BOOST_CHECK_NE(std::string::npos, message.find("in function 'outer'"));
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_pcall_error_object)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		luaopen_base(s.state());
+		lua_settop(s.state(), 0);
+		lua::load_buffer(*s.state(), Si::make_c_str_range("error({})"), "test").value().release();
+		BOOST_CHECK_THROW(lua::pcall(*s.state(), 0, 0), lua::lua_exception);
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_pcall_message_handler_is_cached)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::load_buffer(*s.state(), Si::make_c_str_range("return 1"), "test").value().release();
+		lua::pcall(*s.state(), 0, 0).pop();
+		lua::detail::push_message_handler(*s.state());
+		void const * const first = lua_topointer(s.state(), -1);
+		lua_pop(s.state(), 1);
+		lua::load_buffer(*s.state(), Si::make_c_str_range("return 1"), "test").value().release();
+		lua::pcall(*s.state(), 0, 0).pop();
+		lua::detail::push_message_handler(*s.state());
+		BOOST_CHECK_EQUAL(first, lua_topointer(s.state(), -1));
+		lua_pop(s.state(), 1);
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_try_pcall_success)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::load_buffer(*s.state(), Si::make_c_str_range("return 12, 34"), "test").value().release();
+		lua::call_result result = lua::try_pcall(*s.state(), 0, boost::none);
+		BOOST_CHECK(!result.error);
+		BOOST_CHECK(!result.error_value.thread());
+		BOOST_REQUIRE_EQUAL(2, result.results.size());
+		BOOST_CHECK_EQUAL(34, lua::to_integer(lua::at(result.results, 1)));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_try_call_error)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range(
+			"return function (input) if input < 0 then error({reason = 'negative'}) end return input end"
+			), "test").value();
+		luaopen_base(s.state());
+		lua_settop(s.state(), 1);
+		lua::stack_value validate = s.call(compiled, lua::no_arguments(), lua::one());
+		std::array<lua_Integer, 1> const arguments = {{-1}};
+		lua::call_result result = s.try_call(validate, Si::make_container_source(arguments), 1);
+		BOOST_CHECK_EQUAL(boost::system::error_code(LUA_ERRRUN, lua::get_lua_error_category()), result.error);
+		BOOST_REQUIRE_EQUAL(lua::type::table, lua::get_type(result.error_value));
+		lua::stack_value reason = result.error_value["reason"];
+		BOOST_CHECK_EQUAL(boost::make_optional(Si::noexcept_string("negative")), lua::get_string(reason));
+		BOOST_CHECK(!result.results.thread());
+	});
+}
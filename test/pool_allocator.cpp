@@ -0,0 +1,65 @@
+#include <boost/test/unit_test.hpp>
+#include "luacpp/pool_allocator.hpp"
+#include "luacpp/stack.hpp"
+#include "luacpp/load.hpp"
+
+BOOST_AUTO_TEST_CASE(pool_allocator_reallocate_keeps_content)
+{
+	lua::pool_allocator allocator;
+	std::size_t const sizes[] = {1, 15, 16, 17, 100, 256, 257, 4000, 200, 3};
+	std::size_t old_size = 0;
+	char *block = nullptr;
+	for (std::size_t new_size : sizes)
+	{
+		block = static_cast<char *>(allocator.reallocate(block, old_size, new_size));
+		BOOST_REQUIRE(block);
+		for (std::size_t i = 0; i < (std::min)(old_size, new_size); ++i)
+		{
+			BOOST_REQUIRE_EQUAL(static_cast<char>(i), block[i]);
+		}
+		for (std::size_t i = 0; i < new_size; ++i)
+		{
+			block[i] = static_cast<char>(i);
+		}
+		old_size = new_size;
+	}
+	BOOST_CHECK(!allocator.reallocate(block, old_size, 0));
+}
+
+BOOST_AUTO_TEST_CASE(pool_allocator_reuses_freed_blocks)
+{
+	lua::pool_allocator allocator;
+	void * const first = allocator.reallocate(nullptr, 0, 24);
+	BOOST_REQUIRE(first);
+	BOOST_CHECK(!allocator.reallocate(first, 24, 0));
+	void * const second = allocator.reallocate(nullptr, 0, 32);
+	BOOST_CHECK_EQUAL(first, second);
+	BOOST_CHECK(!allocator.reallocate(second, 32, 0));
+}
+
+BOOST_AUTO_TEST_CASE(pool_allocator_create_lua)
+{
+	lua::pool_allocator allocator;
+	auto state = lua::create_lua(allocator);
+	BOOST_REQUIRE(state);
+	lua_State &L = *state;
+	lua::stack s(L);
+	luaopen_base(&L);
+	lua_settop(&L, 0);
+	{
+		lua::stack_value compiled = lua::load_buffer(L, Si::make_c_str_range(
+			"local t = {}\n"
+			"for i = 1, 1000 do\n"
+			"    t[i] = {name = \"element\" .. i, get = function () return i end}\n"
+			"end\n"
+			"local sum = 0\n"
+			"for i, e in ipairs(t) do\n"
+			"    sum = sum + e.get()\n"
+			"end\n"
+			"return sum\n"
+			), "test").value();
+		lua::stack_value result = s.call(compiled, lua::no_arguments(), lua::one());
+		BOOST_CHECK_EQUAL(boost::make_optional<lua_Integer>(500500), get_integer(result));
+	}
+	BOOST_CHECK_EQUAL(0, lua_gettop(&L));
+}
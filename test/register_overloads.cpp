@@ -0,0 +1,77 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "luacpp/register_overloads.hpp"
+#include "luacpp/load.hpp"
+
+namespace
+{
+	lua::stack_value register_describe(lua::stack &s)
+	{
+		return lua::register_overloads(
+			s,
+			[](lua_Number) -> Si::noexcept_string
+			{
+				return "number";
+			},
+			[](Si::noexcept_string const &) -> Si::noexcept_string
+			{
+				return "string";
+			},
+			[](lua::any_local const &, lua_Number) -> Si::noexcept_string
+			{
+				return "anything and a number";
+			},
+			[](lua_State &L) -> Si::noexcept_string
+			{
+				BOOST_CHECK_EQUAL(0, lua_gettop(&L));
+				return "nothing";
+			}
+		);
+	}
+
+	Si::noexcept_string describe(lua::stack &s, char const *arguments)
+	{
+		{
+			lua::stack_value describe = register_describe(s);
+			lua::push(*s.state(), describe);
+			lua_setglobal(s.state(), "describe");
+		}
+		std::string code = "return describe(";
+		code += arguments;
+		code += ")";
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_memory_range(code), "test").value();
+		lua::stack_value result = s.call(compiled, lua::no_arguments(), lua::one());
+		boost::optional<Si::noexcept_string> description = lua::get_string(result);
+		BOOST_REQUIRE(description);
+		return *description;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(lua_register_overloads_dispatch)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		BOOST_CHECK_EQUAL("number", describe(s, "1"));
+		BOOST_CHECK_EQUAL("string", describe(s, "'1'"));
+		BOOST_CHECK_EQUAL("anything and a number", describe(s, "{}, 2"));
+		BOOST_CHECK_EQUAL("anything and a number", describe(s, "'a', 2"));
+		BOOST_CHECK_EQUAL("nothing", describe(s, ""));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_register_overloads_no_match)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		try
+		{
+			describe(s, "true");
+			BOOST_FAIL("an exception was expected");
+		}
+		catch (lua::lua_exception const &ex)
+		{
+			std::string const message = ex.what();
+			BOOST_CHECK_NE(std::string::npos, message.find("no overload accepts the arguments (boolean)"));
+		}
+	});
+}
@@ -0,0 +1,97 @@
+#include <boost/test/unit_test.hpp>
+#include "luacpp/state_pool.hpp"
+#include "luacpp/accounting_allocator.hpp"
+#include "luacpp/stack.hpp"
+#include "luacpp/load.hpp"
+
+namespace
+{
+	void initialize(lua_State &L)
+	{
+		luaopen_base(&L);
+		lua_settop(&L, 0);
+		lua::stack_value compiled = lua::load_buffer(L, Si::make_c_str_range("counter = 0 function count() counter = counter + 1 return counter end"), "test").value();
+		lua::stack s(L);
+		s.call(compiled, lua::no_arguments(), 0);
+	}
+
+	lua_Integer run(lua_State &L, char const *code)
+	{
+		lua::stack s(L);
+		lua::stack_value compiled = lua::load_buffer(L, Si::make_c_str_range(code), "test").value();
+		lua::stack_value result = s.call(compiled, lua::no_arguments(), lua::one());
+		return lua::to_integer(result);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(state_pool_prepare)
+{
+	lua::state_pool pool(initialize, 3);
+	BOOST_CHECK_EQUAL(3u, pool.idle_count());
+	{
+		lua::pooled_state state = pool.acquire();
+		BOOST_REQUIRE(state.get());
+		BOOST_CHECK_EQUAL(2u, pool.idle_count());
+		BOOST_CHECK_EQUAL(1, run(*state, "return count()"));
+	}
+	BOOST_CHECK_EQUAL(3u, pool.idle_count());
+}
+
+BOOST_AUTO_TEST_CASE(state_pool_grows_on_demand)
+{
+	lua::state_pool pool(initialize);
+	BOOST_CHECK_EQUAL(0u, pool.idle_count());
+	{
+		lua::pooled_state first = pool.acquire();
+		lua::pooled_state second = pool.acquire();
+		BOOST_CHECK(first.get() != second.get());
+	}
+	BOOST_CHECK_EQUAL(2u, pool.idle_count());
+}
+
+BOOST_AUTO_TEST_CASE(state_pool_reset)
+{
+	lua::state_pool pool(initialize, 1);
+	lua_State *used = nullptr;
+	int reference_key = LUA_NOREF;
+	{
+		lua::pooled_state state = pool.acquire();
+		used = state.get();
+		BOOST_CHECK_EQUAL(1, run(*state, "return count()"));
+		BOOST_CHECK_EQUAL(2, run(*state, "return count()"));
+		BOOST_CHECK_EQUAL(7, run(*state, "created = 7 count = nil return created"));
+		lua_pushinteger(state.get(), 123);
+		reference_key = luaL_ref(state.get(), LUA_REGISTRYINDEX);
+		lua_pushinteger(state.get(), 456);
+	}
+	{
+		lua::pooled_state state = pool.acquire();
+		BOOST_REQUIRE_EQUAL(used, state.get());
+		BOOST_CHECK_EQUAL(0, lua_gettop(state.get()));
+		BOOST_CHECK_EQUAL(1, run(*state, "return created == nil and count()"));
+		BOOST_CHECK_EQUAL(1, run(*state, "return counter"));
+
+		lua_rawgeti(state.get(), LUA_REGISTRYINDEX, reference_key);
+		BOOST_CHECK(lua_isnil(state.get(), -1));
+		lua_pop(state.get(), 1);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(state_pool_reset_reports_memory_errors)
+{
+	lua::accounting_allocator<> allocator;
+	auto state = lua::create_lua(allocator);
+	initialize(*state);
+	lua_settop(state.get(), 0);
+	lua::save_baseline(*state);
+	BOOST_CHECK_EQUAL(7, run(*state, "created = 7 return created"));
+
+	//the state cannot grow any more, so the reset fails instead of calling the panic function
+	allocator.set_limit(0);
+	BOOST_CHECK_EQUAL(LUA_ERRMEM, lua::try_reset_to_baseline(*state));
+	BOOST_CHECK_EQUAL(0, lua_gettop(state.get()));
+
+	allocator.set_limit((std::numeric_limits<std::size_t>::max)());
+	BOOST_CHECK_EQUAL(0, lua::try_reset_to_baseline(*state));
+	BOOST_CHECK_EQUAL(1, run(*state, "return created == nil and count()"));
+}
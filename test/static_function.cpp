@@ -0,0 +1,59 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "luacpp/register_any_function.hpp"
+
+namespace
+{
+	lua_Integer add(lua_Integer left, lua_Integer right)
+	{
+		return left + right;
+	}
+
+	bool was_called = false;
+
+	void remember_call(lua_State &)
+	{
+		was_called = true;
+	}
+
+	std::pair<lua_Integer, lua_Integer> divide(lua_Integer dividend, lua_Integer divisor)
+	{
+		return std::make_pair(dividend / divisor, dividend % divisor);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(lua_register_static_function)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value function = LUA_CPP_REGISTER_FUNCTION(*s.state(), add);
+		BOOST_CHECK(lua_iscfunction(s.state(), function.from_bottom()));
+		BOOST_REQUIRE(lua_getupvalue(s.state(), function.from_bottom(), 1) == nullptr);
+		std::array<lua_Integer, 2> const arguments = {{2, 3}};
+		lua::stack_value result = s.call(function, Si::make_container_source(arguments), lua::one());
+		BOOST_CHECK_EQUAL(5, lua::to_integer(result));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_register_static_function_void)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		was_called = false;
+		lua::stack_value function = lua::register_function<decltype(&remember_call), &remember_call>(*s.state());
+		s.call(function, lua::no_arguments(), 0);
+		BOOST_CHECK(was_called);
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_register_static_function_multiple_results)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value function = LUA_CPP_REGISTER_FUNCTION(*s.state(), divide);
+		std::array<lua_Integer, 2> const arguments = {{7, 2}};
+		lua::stack_array results = s.call(function, Si::make_container_source(arguments), 2);
+		BOOST_CHECK_EQUAL(3, lua::to_integer(lua::at(results, 0)));
+		BOOST_CHECK_EQUAL(1, lua::to_integer(lua::at(results, 1)));
+	});
+}
@@ -0,0 +1,181 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "luacpp/string_view.hpp"
+#include "luacpp/register_any_function.hpp"
+#include "luacpp/load.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	///the counter of the innermost counting_scope, nullptr while no scope is alive
+	std::size_t *active_allocation_counter = nullptr;
+
+	///Counts the uses of the global operator new during its lifetime. Outside of a scope the replacement operators
+	///behave like the default ones, so the rest of the test executable is not affected.
+	struct counting_scope
+	{
+		std::size_t allocations;
+
+		counting_scope() BOOST_NOEXCEPT
+			: allocations(0)
+			, m_outer(active_allocation_counter)
+		{
+			active_allocation_counter = &allocations;
+		}
+
+		~counting_scope() BOOST_NOEXCEPT
+		{
+			assert(active_allocation_counter == &allocations);
+			active_allocation_counter = m_outer;
+		}
+
+	private:
+
+		std::size_t *m_outer;
+
+		SILICIUM_DELETED_FUNCTION(counting_scope(counting_scope const &))
+		SILICIUM_DELETED_FUNCTION(counting_scope &operator = (counting_scope const &))
+	};
+}
+
+void *operator new(std::size_t size)
+{
+	if (active_allocation_counter)
+	{
+		++*active_allocation_counter;
+	}
+	void * const memory = std::malloc(size ? size : 1);
+	if (!memory)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void *operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void *memory) BOOST_NOEXCEPT
+{
+	std::free(memory);
+}
+
+void operator delete[](void *memory) BOOST_NOEXCEPT
+{
+	std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) BOOST_NOEXCEPT
+{
+	std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) BOOST_NOEXCEPT
+{
+	std::free(memory);
+}
+
+namespace
+{
+	std::size_t const calls = 1000;
+
+	char const * const header_loop =
+		"local header = ...\n"
+		"for i = 1, 1000 do\n"
+		"    header(\"Content-Type-With-A-Long-Name\", \"application/x-something-long-enough\")\n"
+		"end\n";
+
+	///counts the C++ heap allocations while a Lua loop passes two long strings to a function taking String
+	template <class String>
+	std::size_t count_heap_allocations(lua::stack &s)
+	{
+		std::size_t total_size = 0;
+		lua::stack_value header = lua::register_any_function(s, [&total_size](String key, String value)
+		{
+			total_size += key.size() + value.size();
+		});
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range(header_loop), "test").value();
+		std::array<lua::any_local, 1> const arguments = {{header}};
+		std::size_t allocations = 0;
+		{
+			counting_scope counter;
+			s.call(compiled, Si::make_container_source(arguments), 0);
+			allocations = counter.allocations;
+		}
+		BOOST_CHECK_EQUAL(calls * (29u + 35u), total_size);
+		return allocations;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(string_view_arguments_are_not_copied)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		char const *received = nullptr;
+		lua::stack_value function = lua::register_any_function(s, [&received](lua::string_view key)
+		{
+			received = key.data();
+		});
+		lua::push(*s.state(), Si::make_c_str_range("Content-Type"));
+		lua::stack_value str(*s.state(), lua_gettop(s.state()));
+		std::array<lua::any_local, 1> const arguments = {{str}};
+		s.call(function, Si::make_container_source(arguments), 0);
+		BOOST_CHECK_EQUAL(lua_tostring(s.state(), str.from_bottom()), received);
+	});
+}
+
+BOOST_AUTO_TEST_CASE(string_view_arguments_do_not_allocate)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		BOOST_CHECK_EQUAL(0u, count_heap_allocations<lua::string_view>(s));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(string_view_noexcept_string_arguments_allocate)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		//makes sure that the counter actually works: the strings are too long for a small string optimization
+		BOOST_CHECK_GE(count_heap_allocations<Si::noexcept_string const &>(s), calls);
+	});
+}
+
+BOOST_AUTO_TEST_CASE(string_view_conversions)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::push(*s.state(), Si::make_c_str_range("abc"));
+		lua::stack_value str(*s.state(), lua_gettop(s.state()));
+		lua::string_view const view = lua::from_lua_cast<lua::string_view>(str);
+		BOOST_CHECK_EQUAL(lua_tostring(s.state(), str.from_bottom()), view.data());
+		BOOST_CHECK(view == "abc");
+
+		lua::push(*s.state(), static_cast<lua_Integer>(123));
+		lua::stack_value number(*s.state(), lua_gettop(s.state()));
+		BOOST_CHECK(!lua::get_string_view(number));
+		BOOST_CHECK(lua::to_string_view(number) == "123");
+		BOOST_CHECK(lua::get_string_view(number));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(string_view_pinned)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::pinned_string_view pinned;
+		{
+			lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range("return 'a string' .. ' created by Lua'"), "test").value();
+			lua::stack_value str = s.call(compiled, lua::no_arguments(), lua::one());
+			pinned = lua::pin_string_view(lua::main_thread(*s.state()), str);
+		}
+		lua_gc(s.state(), LUA_GCCOLLECT, 0);
+		BOOST_CHECK(pinned.view() == "a string created by Lua");
+		lua::stack_value anchored = lua::to_local(*s.state(), pinned.anchor());
+		BOOST_CHECK_EQUAL(pinned.view().data(), lua::to_string_view(anchored).data());
+	});
+}
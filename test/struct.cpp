@@ -0,0 +1,70 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "luacpp/struct.hpp"
+#include "luacpp/load.hpp"
+
+namespace test
+{
+	struct point
+	{
+		lua_Number x;
+		lua_Number y;
+	};
+
+	struct request_metadata
+	{
+		Si::noexcept_string method;
+		lua_Integer status;
+		bool keep_alive;
+		point origin;
+		std::vector<lua_Integer> ports;
+	};
+}
+
+LUA_CPP_STRUCT(test::point, (x)(y))
+LUA_CPP_STRUCT(test::request_metadata, (method)(status)(keep_alive)(origin)(ports))
+
+BOOST_AUTO_TEST_CASE(struct_push)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range(
+			"local r = ...\n"
+			"return (r.method == 'GET') and (r.status == 200) and r.keep_alive and\n"
+			"    (r.origin.x == 1.5) and (r.origin.y == -2) and (#r.ports == 2) and (r.ports[2] == 443)\n"
+			), "test").value();
+		test::request_metadata const original{"GET", 200, true, test::point{1.5, -2}, {80, 443}};
+		std::array<test::request_metadata, 1> const arguments = {{original}};
+		lua::stack_value result = s.call(compiled, Si::make_container_source(arguments), lua::one());
+		BOOST_CHECK_EQUAL(boost::make_optional(true), get_boolean(result));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(struct_round_trip)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		test::request_metadata const original{"POST", 404, false, test::point{3, 4}, {1, 2, 3}};
+		lua::push(*s.state(), original);
+		lua::stack_value table(*s.state(), lua_gettop(s.state()));
+		test::request_metadata const converted = lua::from_lua_cast<test::request_metadata>(table);
+		BOOST_CHECK_EQUAL(original.method, converted.method);
+		BOOST_CHECK_EQUAL(original.status, converted.status);
+		BOOST_CHECK_EQUAL(original.keep_alive, converted.keep_alive);
+		BOOST_CHECK_EQUAL(original.origin.x, converted.origin.x);
+		BOOST_CHECK_EQUAL(original.origin.y, converted.origin.y);
+		BOOST_CHECK(original.ports == converted.ports);
+	});
+}
+
+BOOST_AUTO_TEST_CASE(struct_missing_fields)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range("return {y = 7}"), "test").value();
+		lua::stack_value table = s.call(compiled, lua::no_arguments(), lua::one());
+		test::point const converted = lua::from_lua_cast<test::point>(table);
+		BOOST_CHECK_EQUAL(0, converted.x);
+		BOOST_CHECK_EQUAL(7, converted.y);
+	});
+}
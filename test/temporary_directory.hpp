@@ -0,0 +1,33 @@
+#ifndef LUACPP_TEST_TEMPORARY_DIRECTORY_HPP
+#define LUACPP_TEST_TEMPORARY_DIRECTORY_HPP
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+namespace test
+{
+	struct temporary_directory
+	{
+		boost::filesystem::path path;
+
+		temporary_directory()
+			: path(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+		{
+			boost::filesystem::create_directories(path);
+		}
+
+		~temporary_directory()
+		{
+			boost::system::error_code ignored;
+			boost::filesystem::remove_all(path, ignored);
+		}
+	};
+
+	inline void write_file(boost::filesystem::path const &file, std::string const &content)
+	{
+		boost::filesystem::ofstream out(file, std::ios::binary);
+		out << content;
+	}
+}
+
+#endif
@@ -0,0 +1,127 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "luacpp/meta_table.hpp"
+#include "luacpp/register_closure.hpp"
+#include <memory>
+
+namespace
+{
+	struct registered_object
+	{
+		int value;
+	};
+
+	void push_meta_table(lua_State &L, int function)
+	{
+		BOOST_REQUIRE(lua_getupvalue(&L, function, 1));
+		BOOST_REQUIRE(lua_getmetatable(&L, -1));
+		lua_remove(&L, -2);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(lua_create_default_meta_table_is_cached)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		int initialized = 0;
+		auto const initialize = [&s, &initialized](lua::stack_value &meta)
+		{
+			++initialized;
+			lua::set_element(meta, "answer", static_cast<lua_Integer>(42));
+		};
+		lua::stack_value first = lua::create_default_meta_table<registered_object>(s, initialize);
+		lua::stack_value second = lua::create_default_meta_table<registered_object>(s, initialize);
+		lua::stack_value third = lua::create_default_meta_table<registered_object>(s);
+		BOOST_CHECK_EQUAL(1, initialized);
+		BOOST_CHECK(lua_rawequal(s.state(), first.from_bottom(), second.from_bottom()));
+		BOOST_CHECK(lua_rawequal(s.state(), first.from_bottom(), third.from_bottom()));
+		lua::stack_value answer = third["answer"];
+		BOOST_CHECK_EQUAL(42, lua::to_integer(answer));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_emplace_object_with_registered_meta_table)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value object = lua::emplace_object<registered_object>(s, lua::registered_meta_table<registered_object>(), 3);
+		BOOST_CHECK_EQUAL(3, lua::assume_type<registered_object>(object).value);
+		BOOST_REQUIRE(lua_getmetatable(s.state(), object.from_bottom()));
+		lua::stack_value actual(*s.state(), lua_gettop(s.state()));
+		lua::stack_value expected = lua::create_default_meta_table<registered_object>(s);
+		BOOST_CHECK(lua_rawequal(s.state(), actual.from_bottom(), expected.from_bottom()));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_register_closure_shares_meta_table)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		auto const make_closure = [](int value)
+		{
+			//the shared_ptr makes the closure need a finalizer
+			auto const shared_value = std::make_shared<int>(value);
+			return [shared_value](lua_State *L) -> lua::result_or_yield
+			{
+				lua_pushinteger(L, *shared_value);
+				return 1;
+			};
+		};
+		lua::stack_value first = lua::register_closure(s, make_closure(1));
+		lua::stack_value second = lua::register_closure(s, make_closure(2));
+		push_meta_table(*s.state(), first.from_bottom());
+		lua::stack_value first_meta(*s.state(), lua_gettop(s.state()));
+		push_meta_table(*s.state(), second.from_bottom());
+		lua::stack_value second_meta(*s.state(), lua_gettop(s.state()));
+		BOOST_CHECK(lua_rawequal(s.state(), first_meta.from_bottom(), second_meta.from_bottom()));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_register_closure_trivially_destructible_has_no_finalizer)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		int const value = 5;
+		lua::stack_value closure = lua::register_closure(s, [value](lua_State *L) -> lua::result_or_yield
+		{
+			lua_pushinteger(L, value);
+			return 1;
+		});
+		BOOST_REQUIRE(lua_getupvalue(s.state(), closure.from_bottom(), 1));
+		lua::stack_value data(*s.state(), lua_gettop(s.state()));
+		BOOST_CHECK_EQUAL(lua::type::user_data, lua::get_type(data));
+		BOOST_CHECK(!lua_getmetatable(s.state(), data.from_bottom()));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_default_meta_table_trivially_destructible_has_no_gc)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value trivial = lua::create_default_meta_table<registered_object>(s);
+		lua::stack_value trivial_gc = trivial["__gc"];
+		BOOST_CHECK_EQUAL(lua::type::nil, lua::get_type(trivial_gc));
+		lua::stack_value non_trivial = lua::create_default_meta_table<std::shared_ptr<int>>(s);
+		lua::stack_value non_trivial_gc = non_trivial["__gc"];
+		BOOST_CHECK_EQUAL(lua::type::function, lua::get_type(non_trivial_gc));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(lua_to_object_compares_the_meta_table)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value object = lua::emplace_object<registered_object>(s, lua::registered_meta_table<registered_object>(), 3);
+		lua::stack_value other = lua::emplace_object<std::shared_ptr<int>>(s, lua::registered_meta_table<std::shared_ptr<int>>());
+		lua_pushlightuserdata(s.state(), &s);
+		lua::stack_value light(*s.state(), lua_gettop(s.state()));
+		BOOST_CHECK_EQUAL(lua::to_user_data(object), lua::to_object<registered_object>(*s.state(), object.from_bottom()));
+		BOOST_CHECK(!lua::to_object<registered_object>(*s.state(), other.from_bottom()));
+		BOOST_CHECK(!lua::to_object<registered_object>(*s.state(), light.from_bottom()));
+		BOOST_CHECK(!lua::to_object<registered_object>(*s.state(), -1));
+		BOOST_CHECK_EQUAL(lua::to_user_data(other), lua::to_object<std::shared_ptr<int>>(*s.state(), -2));
+
+		//a type without a registered meta table accepts nothing
+		BOOST_CHECK(!lua::to_object<long>(*s.state(), object.from_bottom()));
+	});
+}
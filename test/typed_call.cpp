@@ -0,0 +1,42 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "luacpp/from_lua_cast.hpp"
+#include "luacpp/load.hpp"
+
+BOOST_AUTO_TEST_CASE(typed_call_results)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range(
+			"return function (a, b, name) return a + b, a * b, name .. '!' end"
+			), "test").value();
+		lua::stack_value function = s.call(compiled, lua::no_arguments(), lua::one());
+		std::tuple<lua_Integer, lua_Number, Si::noexcept_string> const results =
+			s.call<lua_Integer, lua_Number, Si::noexcept_string>(function, static_cast<lua_Integer>(3), 1.5, "name");
+		BOOST_CHECK_EQUAL(4, std::get<0>(results));
+		BOOST_CHECK_EQUAL(4.5, std::get<1>(results));
+		BOOST_CHECK_EQUAL("name!", std::get<2>(results));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(typed_call_missing_results_are_nil)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range("return function () return true end"), "test").value();
+		lua::stack_value function = s.call(compiled, lua::no_arguments(), lua::one());
+		std::tuple<bool, lua_Integer> const results = s.call<bool, lua_Integer>(function);
+		BOOST_CHECK(std::get<0>(results));
+		BOOST_CHECK_EQUAL(0, std::get<1>(results));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(typed_call_error)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		lua::stack_value compiled = lua::load_buffer(*s.state(), Si::make_c_str_range("return function () error('failed') end"), "test").value();
+		lua::stack_value function = s.call(compiled, lua::no_arguments(), lua::one());
+		BOOST_CHECK_THROW(s.call<lua_Integer>(function), lua::lua_exception);
+	});
+}
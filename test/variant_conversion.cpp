@@ -0,0 +1,48 @@
+#include <boost/test/unit_test.hpp>
+#include "test_with_environment.hpp"
+#include "luacpp/from_lua_cast.hpp"
+
+namespace
+{
+	template <class Variant, class Pushable>
+	Variant convert(lua::stack &s, Pushable const &value)
+	{
+		lua::push(*s.state(), value);
+		lua::stack_value pushed(*s.state(), lua_gettop(s.state()));
+		return lua::from_lua_cast<Variant>(pushed);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(variant_conversion_dispatch_on_type)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		typedef Si::fast_variant<bool, lua_Number, Si::noexcept_string> variant;
+		BOOST_CHECK_EQUAL(variant(true), convert<variant>(s, true));
+		BOOST_CHECK_EQUAL(variant(2.5), convert<variant>(s, 2.5));
+		BOOST_CHECK_EQUAL(variant(Si::noexcept_string("abc")), convert<variant>(s, "abc"));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(variant_conversion_first_matching_alternative_wins)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		typedef Si::fast_variant<lua_Integer, lua_Number> integer_first;
+		BOOST_CHECK_EQUAL(integer_first(static_cast<lua_Integer>(2)), convert<integer_first>(s, 2.5));
+		typedef Si::fast_variant<lua_Number, lua_Integer> number_first;
+		BOOST_CHECK_EQUAL(number_first(2.5), convert<number_first>(s, 2.5));
+		typedef Si::fast_variant<Si::noexcept_string, char const *> string_first;
+		BOOST_CHECK_EQUAL(string_first(Si::noexcept_string("abc")), convert<string_first>(s, "abc"));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(variant_conversion_fallback_to_last_alternative)
+{
+	test::test_with_environment([](lua::stack &s, test::resource)
+	{
+		typedef Si::fast_variant<Si::noexcept_string, lua_Integer> variant;
+		BOOST_CHECK_EQUAL(variant(static_cast<lua_Integer>(0)), convert<variant>(s, lua::nil()));
+		BOOST_CHECK_EQUAL(variant(static_cast<lua_Integer>(0)), convert<variant>(s, true));
+	});
+}